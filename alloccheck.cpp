@@ -0,0 +1,106 @@
+// 搜索内存分配检查: 搜索过程中不应申请堆内存
+// 用法:
+//   alloccheck
+// 以计数的全局 operator new 替换默认实现, 对若干局面在预热后调用 getBestMove(2) 与 getBestMove(3),
+// 期间发生任何堆分配即输出分配次数并返回非零
+#include <QTextStream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "search.h"
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<quint64> g_allocations{0};
+
+void *countedAlloc(std::size_t size)
+{
+    if (g_counting.load(std::memory_order_relaxed)) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// 与 bench 相同的 8x8 基准局面
+const char *const Positions[] = {
+    "4x1x1/2B1W1B1/2x2x1B/5xWx/1x2x2B/2x4W/8/Wx6 w",
+    "xx1Bx3/BxxxBW2/2x4x/5xx1/x2xxxBx/Wx2W3/3xx2x/3W1x2 w",
+    "5Bx1/1xxx1x2/x1Bxx2x/xW3x1x/1xxx1x1x/1xxxxWx1/1x1xBxx1/1BxxWxxW w",
+    "2B2B2/8/B6B/x7/8/W6W/3x4/2W2W2 b",
+};
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    if (void *p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    if (void *p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+// Search 的友元, 直接调用根节点搜索
+struct AllocCheck
+{
+    // 按迭代加深的准备步骤重置搜索状态后调用 getBestMove(depth), 返回期间的堆分配次数
+    static quint64 run(Search<8> &search, int depth)
+    {
+        search.m_tt->newSearch();
+        search.m_timer.start();
+        search.m_timeBudget = 0;
+        search.m_cancel = nullptr;
+        search.m_ponder = nullptr;
+        search.m_stopFlag = false;
+        search.resetThreadState();
+
+        double score = 0.0;
+        g_allocations = 0;
+        g_counting = true;
+        search.getBestMove(depth, -1e11, 1e11, score);
+        g_counting = false;
+        return g_allocations;
+    }
+};
+
+int main()
+{
+    bool ok = true;
+    for (const char *fen : Positions) {
+        BasicPosition<8> position;
+        if (!BasicPosition<8>::fromFen(QString::fromLatin1(fen), position)) {
+            out() << "invalid position: " << fen << Qt::endl;
+            return 1;
+        }
+        out() << fen << Qt::endl;
+
+        // 预热: 分配置换表与搜索栈, 并让惰性初始化的静态表完成初始化
+        Search<8> search(position.whiteToMove);
+        search.setRootPosition(position);
+        search.nextMove(1);
+
+        for (int depth : {2, 3}) {
+            const quint64 allocations = AllocCheck::run(search, depth);
+            out() << "  getBestMove(" << depth << ")  allocations " << allocations << Qt::endl;
+            if (allocations > 0) ok = false;
+        }
+    }
+
+    out() << (ok ? "OK" : "FAILED: the search allocated heap memory") << Qt::endl;
+    return ok ? 0 : 1;
+}
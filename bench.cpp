@@ -0,0 +1,164 @@
+// 搜索基准: 多线程加速比, 以及选择性搜索参数对节点数的影响
+// 用法:
+//   bench [--fen <局面串>] [--depth <深度>] [--threads <线程数列表>] [--mode smp|ybw] [--half-ply]
+//         [--beam <各剩余深度的束宽列表>] [--lmr <最小深度>] [--futility <余量>]
+//   bench --mcts [--playouts <模拟次数>] [--policy random|eval] [--fen <局面串>] [--threads <线程数列表>]
+// 对每个线程数, 以空置换表对全部局面做固定深度搜索(或固定次数的蒙特卡洛模拟),
+// 输出总耗时、每秒节点数(或模拟次数)及相对第一个线程数的加速比
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "search.h"
+#include "mcts.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// 默认基准局面: 开局后不久、中局与接近官子的 8x8 局面各若干
+const char *const DefaultPositions[] = {
+    "4x1x1/2B1W1B1/2x2x1B/5xWx/1x2x2B/2x4W/8/Wx6 w",
+    "xx1Bx3/BxxxBW2/2x4x/5xx1/x2xxxBx/Wx2W3/3xx2x/3W1x2 w",
+    "5Bx1/1xxx1x2/x1Bxx2x/xW3x1x/1xxx1x1x/1xxxxWx1/1x1xBxx1/1BxxWxxW w",
+    "2B2B2/8/B6B/x7/8/W6W/3x4/2W2W2 b",
+};
+
+struct BenchOptions
+{
+    int depth = 3;
+    int threads = 1;
+    ParallelMode mode = ParallelMode::LazySmp;
+    bool halfPly = false; // 半步搜索, 此时深度以半步计
+    SearchOptions search;  // 选择性搜索的参数
+    bool mcts = false;
+    quint64 playouts = Mcts<8>::DefaultPlayouts;
+    PlayoutPolicy policy = PlayoutPolicy::Random;
+};
+
+struct BenchResult
+{
+    qint64 timeMs = 0;
+    quint64 nodes = 0; // 搜索节点数, 蒙特卡洛树搜索中为模拟次数
+};
+
+// 按选项搜索一个局面, 局面串非法时返回 false
+template <int N>
+bool runSearch(const QString &fen, const BenchOptions &options, BenchResult &result)
+{
+    BasicPosition<N> position;
+    if (!BasicPosition<N>::fromFen(fen, position)) return false;
+
+    if (options.mcts) {
+        Mcts<N> mcts(position.whiteToMove);
+        mcts.setThreadCount(options.threads);
+        mcts.setPlayoutPolicy(options.policy);
+        MctsLimits limits;
+        limits.playouts = options.playouts;
+        const auto move = mcts.search(position, limits);
+        const MctsInfo &info = mcts.lastSearchInfo();
+
+        out() << "  " << move.toString() << "  win rate " << info.winRate
+              << "  playouts " << info.playouts << "  tree nodes " << info.treeNodes
+              << "  time " << info.timeMs << " ms" << Qt::endl;
+        result.timeMs += info.timeMs;
+        result.nodes += info.playouts;
+        return true;
+    }
+
+    Search<N> search(position.whiteToMove);
+    search.setThreadCount(options.threads);
+    search.setParallelMode(options.mode);
+    search.setHalfPlySearch(options.halfPly);
+    search.setOptions(options.search);
+    search.setRootPosition(position);
+    const auto move = search.nextMove(options.depth);
+    const SearchInfo &info = search.lastSearchInfo();
+
+    out() << "  " << move.toString() << "  score " << info.score
+          << "  nodes " << info.nodes << "  time " << info.timeMs << " ms" << Qt::endl;
+    result.timeMs += info.timeMs;
+    result.nodes += info.nodes;
+    return true;
+}
+
+// 按棋盘尺寸分派到对应的模板实例
+bool runSearch(const QString &fen, const BenchOptions &options, BenchResult &result)
+{
+    switch (fenBoardSize(fen)) {
+    case 8: return runSearch<8>(fen, options, result);
+    case 10: return runSearch<10>(fen, options, result);
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Amazons search thread scaling benchmark");
+    parser.addHelpOption();
+    QCommandLineOption fenOption("fen", "Position to search (default: built-in set).", "fen");
+    QCommandLineOption depthOption("depth", "Search depth (default: 3).", "depth", "3");
+    QCommandLineOption threadsOption("threads", "Comma-separated thread counts (default: 1,2,4).", "list", "1,2,4");
+    QCommandLineOption modeOption("mode", "Parallel search: smp (Lazy SMP) or ybw (Young Brothers Wait).", "mode", "smp");
+    QCommandLineOption halfPlyOption("half-ply", "Search queen moves and arrow shots as separate plies (depth counts half-plies).");
+    QCommandLineOption beamOption("beam", "Comma-separated beam widths by remaining depth, starting at 1 (0 = full width).", "list");
+    QCommandLineOption lmrOption("lmr", "Reduce late moves at nodes with at least this remaining depth (0 = off).", "depth", "0");
+    QCommandLineOption futilityOption("futility", "Futility margin per remaining depth at frontier nodes (0 = off).", "margin", "0");
+    QCommandLineOption mctsOption("mcts", "Benchmark Monte-Carlo tree search instead of alpha-beta.");
+    QCommandLineOption playoutsOption("playouts", "Playouts per position for --mcts.", "count",
+                                      QString::number(Mcts<8>::DefaultPlayouts));
+    QCommandLineOption policyOption("policy", "Playout policy for --mcts: random or eval.", "policy", "random");
+    parser.addOptions({fenOption, depthOption, threadsOption, modeOption, halfPlyOption,
+                       beamOption, lmrOption, futilityOption, mctsOption, playoutsOption, policyOption});
+    parser.process(app);
+
+    QStringList fens;
+    if (parser.isSet(fenOption)) {
+        fens.append(parser.value(fenOption));
+    } else {
+        for (const char *fen : DefaultPositions) fens.append(QString::fromLatin1(fen));
+    }
+    BenchOptions options;
+    options.depth = parser.value(depthOption).toInt();
+    options.mode = parser.value(modeOption) == "ybw" ? ParallelMode::YoungBrothersWait : ParallelMode::LazySmp;
+    options.halfPly = parser.isSet(halfPlyOption);
+    for (const QString &field : parser.value(beamOption).split(',', Qt::SkipEmptyParts)) {
+        options.search.beamWidths.append(qMax(field.toInt(), 0));
+    }
+    options.search.lmrMinDepth = parser.value(lmrOption).toInt();
+    options.search.futilityMargin = parser.value(futilityOption).toDouble();
+    options.mcts = parser.isSet(mctsOption);
+    options.playouts = parser.value(playoutsOption).toULongLong();
+    options.policy = parser.value(policyOption) == "eval" ? PlayoutPolicy::EvalGuided : PlayoutPolicy::Random;
+
+    qint64 baseTime = 0;
+    for (const QString &field : parser.value(threadsOption).split(',', Qt::SkipEmptyParts)) {
+        options.threads = qMax(field.toInt(), 1);
+        out() << "threads " << options.threads << Qt::endl;
+
+        BenchResult result;
+        for (const QString &fen : fens) {
+            if (!runSearch(fen, options, result)) {
+                out() << "invalid position: " << fen << Qt::endl;
+                return 1;
+            }
+        }
+
+        // 加速比以列表中第一个线程数的耗时为基准
+        if (baseTime == 0) baseTime = qMax<qint64>(result.timeMs, 1);
+        out() << "  total time " << result.timeMs << " ms  " << (options.mcts ? "playouts " : "nodes ") << result.nodes
+              << (options.mcts ? "  playouts/s " : "  nps ")
+              << static_cast<quint64>(result.nodes * 1000.0 / qMax<qint64>(result.timeMs, 1))
+              << "  speedup " << QString::number(static_cast<double>(baseTime) / qMax<qint64>(result.timeMs, 1), 'f', 2)
+              << Qt::endl;
+    }
+    return 0;
+}
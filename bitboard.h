@@ -0,0 +1,329 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <array>
+#include <type_traits>
+
+// 由两个64位字组成的位棋盘, 供格子数超过64的棋盘(如10x10)使用
+struct Bitboard128
+{
+    quint64 lo = 0;
+    quint64 hi = 0;
+
+    constexpr Bitboard128() = default;
+    constexpr Bitboard128(quint64 low) : lo(low) {}
+    constexpr Bitboard128(quint64 low, quint64 high) : lo(low), hi(high) {}
+
+    constexpr explicit operator bool() const { return (lo | hi) != 0; }
+
+    friend constexpr bool operator==(Bitboard128 a, Bitboard128 b) { return a.lo == b.lo && a.hi == b.hi; }
+    friend constexpr bool operator!=(Bitboard128 a, Bitboard128 b) { return !(a == b); }
+    friend constexpr Bitboard128 operator&(Bitboard128 a, Bitboard128 b) { return {a.lo & b.lo, a.hi & b.hi}; }
+    friend constexpr Bitboard128 operator|(Bitboard128 a, Bitboard128 b) { return {a.lo | b.lo, a.hi | b.hi}; }
+    friend constexpr Bitboard128 operator^(Bitboard128 a, Bitboard128 b) { return {a.lo ^ b.lo, a.hi ^ b.hi}; }
+    friend constexpr Bitboard128 operator~(Bitboard128 a) { return {~a.lo, ~a.hi}; }
+    friend constexpr Bitboard128 operator-(Bitboard128 a, Bitboard128 b) {
+        return {a.lo - b.lo, a.hi - b.hi - (a.lo < b.lo ? 1 : 0)};
+    }
+    friend constexpr Bitboard128 operator<<(Bitboard128 a, int n) {
+        if (n == 0) return a;
+        if (n >= 64) return {0, a.lo << (n - 64)};
+        return {a.lo << n, (a.hi << n) | (a.lo >> (64 - n))};
+    }
+    friend constexpr Bitboard128 operator>>(Bitboard128 a, int n) {
+        if (n == 0) return a;
+        if (n >= 64) return {a.hi >> (n - 64), 0};
+        return {(a.lo >> n) | (a.hi << (64 - n)), a.hi >> n};
+    }
+
+    constexpr Bitboard128 &operator&=(Bitboard128 b) { return *this = *this & b; }
+    constexpr Bitboard128 &operator|=(Bitboard128 b) { return *this = *this | b; }
+    constexpr Bitboard128 &operator^=(Bitboard128 b) { return *this = *this ^ b; }
+};
+
+// 统计置位数
+inline int popCount(quint64 b) { return static_cast<int>(qPopulationCount(b)); }
+inline int popCount(Bitboard128 b) { return popCount(b.lo) + popCount(b.hi); }
+
+// 最低/最高置位的格子编号, 参数不能为空
+inline int lsbIndex(quint64 b) { return static_cast<int>(qCountTrailingZeroBits(b)); }
+inline int lsbIndex(Bitboard128 b) { return b.lo ? lsbIndex(b.lo) : 64 + lsbIndex(b.hi); }
+inline int msbIndex(quint64 b) { return 63 - static_cast<int>(qCountLeadingZeroBits(b)); }
+inline int msbIndex(Bitboard128 b) { return b.hi ? 64 + msbIndex(b.hi) : msbIndex(b.lo); }
+
+// 取出最低置位的格子编号, 并将该位清除
+template <typename B>
+inline int popLsb(B &b)
+{
+    int square = lsbIndex(b);
+    b &= b - B(1);
+    return square;
+}
+
+// 只保留最低置位
+template <typename B>
+constexpr B lowestBit(B b) { return b & (B(0) - b); }
+
+// 八个方向, 顺序与走法生成中的方向顺序一致
+enum Direction {
+    Up = 0,
+    UpRight = 1,
+    Right = 2,
+    DownRight = 3,
+    Down = 4,
+    DownLeft = 5,
+    Left = 6,
+    UpLeft = 7
+};
+
+// 各方向的行列增量
+constexpr int DirectionRowStep[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+constexpr int DirectionColStep[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// N x N 棋盘的几何信息: 第 row * N + col 位对应棋盘上的 (row, col) 格
+// 不超过64格时位棋盘为单个 quint64, 否则为 Bitboard128
+template <int N>
+struct BoardGeometry
+{
+    static constexpr int Size = N;
+    static constexpr int Squares = N * N;
+    static_assert(Squares <= 128, "位棋盘最多支持128格");
+
+    using Bitboard = std::conditional_t<(Squares <= 64), quint64, Bitboard128>;
+
+    // 格子编号与行列索引的互相转换
+    static constexpr int squareOf(int row, int col) { return row * N + col; }
+    static constexpr int rowOf(int square) { return square / N; }
+    static constexpr int colOf(int square) { return square % N; }
+    static constexpr Bitboard squareBit(int square) { return Bitboard(1) << square; }
+
+    // 棋盘内的所有格子
+    static constexpr Bitboard all() {
+        Bitboard b{};
+        for (int square = 0; square < Squares; square++) b |= squareBit(square);
+        return b;
+    }
+    // 指定列的所有格子
+    static constexpr Bitboard column(int col) {
+        Bitboard b{};
+        for (int row = 0; row < N; row++) b |= squareBit(squareOf(row, col));
+        return b;
+    }
+};
+
+template <int N>
+using BitboardOf = typename BoardGeometry<N>::Bitboard;
+
+// 棋盘掩码与边列掩码, 平移时用于丢弃越过边界的位
+template <int N> inline constexpr BitboardOf<N> BoardMask = BoardGeometry<N>::all();
+template <int N> inline constexpr BitboardOf<N> FirstColumn = BoardGeometry<N>::column(0);
+template <int N> inline constexpr BitboardOf<N> LastColumn = BoardGeometry<N>::column(N - 1);
+
+// 将位棋盘整体向某方向平移一格, 越出棋盘的位被丢弃
+template <int N>
+constexpr BitboardOf<N> shiftBitboard(BitboardOf<N> b, int dir)
+{
+    switch (dir) {
+    case Up:        return b >> N;
+    case UpRight:   return (b >> (N - 1)) & ~FirstColumn<N>;
+    case Right:     return (b << 1) & ~FirstColumn<N> & BoardMask<N>;
+    case DownRight: return (b << (N + 1)) & ~FirstColumn<N> & BoardMask<N>;
+    case Down:      return (b << N) & BoardMask<N>;
+    case DownLeft:  return (b << (N - 1)) & ~LastColumn<N> & BoardMask<N>;
+    case Left:      return (b >> 1) & ~LastColumn<N>;
+    case UpLeft:    return (b >> (N + 1)) & ~LastColumn<N>;
+    }
+    return BitboardOf<N>(0);
+}
+
+// 将位棋盘向八个方向各扩张一格(王步邻域)
+template <int N>
+constexpr BitboardOf<N> dilate(BitboardOf<N> b)
+{
+    // 横向扩张后先去掉棋盘以外的位, 否则右下角越界的位会在上移时回到棋盘内
+    const BitboardOf<N> horizontal = (b | ((b << 1) & ~FirstColumn<N>) | ((b >> 1) & ~LastColumn<N>)) & BoardMask<N>;
+    return (horizontal | (horizontal << N) | (horizontal >> N)) & BoardMask<N>;
+}
+
+// 从 seed 出发, 在 passable 范围内做八连通洪水填充, 反复扩张直至不再变化
+template <int N>
+constexpr BitboardOf<N> floodFill(BitboardOf<N> seed, BitboardOf<N> passable)
+{
+    BitboardOf<N> region = seed & passable;
+    while (true) {
+        const BitboardOf<N> next = dilate<N>(region) & passable;
+        if (next == region) return region;
+        region = next;
+    }
+}
+
+// 射线表: 从某格出发沿某方向直至棋盘边缘的所有格子(不含出发格)
+template <int N>
+constexpr std::array<std::array<BitboardOf<N>, N * N>, 8> makeRayMasks()
+{
+    using Geometry = BoardGeometry<N>;
+    std::array<std::array<BitboardOf<N>, N * N>, 8> rays{};
+    for (int dir = 0; dir < 8; dir++) {
+        for (int square = 0; square < N * N; square++) {
+            int r = Geometry::rowOf(square) + DirectionRowStep[dir];
+            int c = Geometry::colOf(square) + DirectionColStep[dir];
+            while (r >= 0 && r < N && c >= 0 && c < N) {
+                rays[dir][square] |= Geometry::squareBit(Geometry::squareOf(r, c));
+                r += DirectionRowStep[dir];
+                c += DirectionColStep[dir];
+            }
+        }
+    }
+    return rays;
+}
+template <int N> inline constexpr auto RayMasks = makeRayMasks<N>();
+
+// 过某格的纵线、主对角线、副对角线(不含该格本身), 供 8x8 棋盘的 Hyperbola Quintessence 使用
+struct LineMasks
+{
+    quint64 file = 0;
+    quint64 diagonal = 0;
+    quint64 antiDiagonal = 0;
+};
+constexpr std::array<LineMasks, 64> makeLineMasks()
+{
+    std::array<LineMasks, 64> lines{};
+    for (int square = 0; square < 64; square++) {
+        lines[square].file = RayMasks<8>[Up][square] | RayMasks<8>[Down][square];
+        lines[square].diagonal = RayMasks<8>[UpLeft][square] | RayMasks<8>[DownRight][square];
+        lines[square].antiDiagonal = RayMasks<8>[UpRight][square] | RayMasks<8>[DownLeft][square];
+    }
+    return lines;
+}
+inline constexpr auto SquareLines = makeLineMasks();
+
+// 横向攻击表: 以所在列与该行的占用状态(8位)为索引, 得到该行内的攻击范围(含第一个阻挡格)
+constexpr std::array<std::array<quint8, 256>, 8> makeRankAttacks()
+{
+    std::array<std::array<quint8, 256>, 8> attacks{};
+    for (int col = 0; col < 8; col++) {
+        for (int occupancy = 0; occupancy < 256; occupancy++) {
+            int result = 0;
+            for (int c = col + 1; c < 8; c++) {
+                result |= 1 << c;
+                if (occupancy & (1 << c)) break;
+            }
+            for (int c = col - 1; c >= 0; c--) {
+                result |= 1 << c;
+                if (occupancy & (1 << c)) break;
+            }
+            attacks[col][occupancy] = static_cast<quint8>(result);
+        }
+    }
+    return attacks;
+}
+inline constexpr auto RankAttacks = makeRankAttacks();
+
+// 字节翻转, 即将 8x8 棋盘上下镜像
+constexpr quint64 flipVertical(quint64 b)
+{
+    b = ((b >> 8) & 0x00ff00ff00ff00ffULL) | ((b & 0x00ff00ff00ff00ffULL) << 8);
+    b = ((b >> 16) & 0x0000ffff0000ffffULL) | ((b & 0x0000ffff0000ffffULL) << 16);
+    return (b >> 32) | (b << 32);
+}
+
+// Hyperbola Quintessence: 沿一条每行至多一格的直线求攻击范围(含第一个阻挡格)
+constexpr quint64 lineAttacks(int square, quint64 occupied, quint64 mask)
+{
+    quint64 forward = occupied & mask;
+    quint64 reverse = flipVertical(forward);
+    forward -= quint64(1) << square;
+    reverse -= flipVertical(quint64(1) << square);
+    forward ^= flipVertical(reverse);
+    return forward & mask;
+}
+
+constexpr quint64 rankAttacks(int square, quint64 occupied)
+{
+    const int shift = square & 56;
+    return quint64(RankAttacks[square & 7][(occupied >> shift) & 0xff]) << shift;
+}
+
+// 获取指定格子上的皇后在给定占用状态下的攻击范围(含第一个阻挡格)
+template <int N>
+inline BitboardOf<N> queenAttacks(int square, BitboardOf<N> occupied)
+{
+    if constexpr (N == 8) {
+        // 8x8: 纵向与斜向用 Hyperbola Quintessence, 横向查表
+        const LineMasks &lines = SquareLines[square];
+        return lineAttacks(square, occupied, lines.file)
+               | lineAttacks(square, occupied, lines.diagonal)
+               | lineAttacks(square, occupied, lines.antiDiagonal)
+               | rankAttacks(square, occupied);
+    } else {
+        // 其他尺寸: 沿每条射线找到最近的阻挡格, 截去其后的部分
+        BitboardOf<N> attacks{};
+        for (int dir = 0; dir < 8; dir++) {
+            BitboardOf<N> ray = RayMasks<N>[dir][square];
+            const BitboardOf<N> blockers = ray & occupied;
+            if (blockers) {
+                // 格子编号递增的方向取最低位, 递减的方向取最高位
+                const bool increasing = dir >= Right && dir <= DownLeft;
+                ray ^= RayMasks<N>[dir][increasing ? lsbIndex(blockers) : msbIndex(blockers)];
+            }
+            attacks |= ray;
+        }
+        return attacks;
+    }
+}
+
+// 获取从指定格子出发按皇后走法能到达的所有空格
+template <int N>
+inline BitboardOf<N> queenReach(int square, BitboardOf<N> empty)
+{
+    return queenAttacks<N>(square, ~empty) & empty;
+}
+
+// 空棋盘上单个皇后的最大走法数, 用于评估函数的标准化
+template <int N>
+constexpr int maxQueenMoves()
+{
+    int best = 0;
+    for (int row = 0; row < N; row++) {
+        for (int col = 0; col < N; col++) {
+            const int mirrored = N - 1 - col;
+            const int diagonal = (row < col ? row : col) + (N - 1 - (row > col ? row : col));
+            const int antiDiagonal = (row < mirrored ? row : mirrored) + (N - 1 - (row > mirrored ? row : mirrored));
+            const int moves = 2 * (N - 1) + diagonal + antiDiagonal;
+            if (moves > best) best = moves;
+        }
+    }
+    return best;
+}
+
+// 只计数不展开的机动性内核: sources 中每一格按皇后走法在 passable 内可滑行到达的格子数之和
+// 八个方向同步逐格平移, 同一步数下不同起点的落点互不重合, 因此逐层 popcount 相加即为总数
+// 对一个棋子的所有落点调用即得其射箭方式总数, 无需逐个落点求可达范围
+template <int N>
+inline int countSlides(BitboardOf<N> sources, BitboardOf<N> passable)
+{
+    BitboardOf<N> up = sources, upRight = sources, right = sources, downRight = sources;
+    BitboardOf<N> down = sources, downLeft = sources, left = sources, upLeft = sources;
+    int count = 0;
+    for (int step = 1; step < N; step++) {
+        up        = shiftBitboard<N>(up, Up) & passable;
+        upRight   = shiftBitboard<N>(upRight, UpRight) & passable;
+        right     = shiftBitboard<N>(right, Right) & passable;
+        downRight = shiftBitboard<N>(downRight, DownRight) & passable;
+        down      = shiftBitboard<N>(down, Down) & passable;
+        downLeft  = shiftBitboard<N>(downLeft, DownLeft) & passable;
+        left      = shiftBitboard<N>(left, Left) & passable;
+        upLeft    = shiftBitboard<N>(upLeft, UpLeft) & passable;
+        count += popCount(up) + popCount(upRight) + popCount(right) + popCount(downRight)
+                 + popCount(down) + popCount(downLeft) + popCount(left) + popCount(upLeft);
+        if (!(up | upRight | right | downRight | down | downLeft | left | upLeft)) break;
+    }
+    return count;
+}
+
+// 界面使用的标准 8x8 棋盘
+using Bitboard = BitboardOf<8>;
+
+#endif // BITBOARD_H
@@ -2,163 +2,130 @@
 #define BOT_H
 
 #include <QObject>
-#include <QVector>
-#include <QSet>
-#include <QJsonObject>
+#include <atomic>
+#include <thread>
 #include "chessboard.h"
+#include "search.h"
+#include "mcts.h"
 
 class Bot : public QObject
 {
     Q_OBJECT
 public:
-    // 所有可能的走法
-    struct AllMoves
-    {
-        // 我方四个棋子的位置
-        std::array<QPair<int, int>, 4> positions;
-        // 对应棋子的所有可行动范围
-        std::array<MoveRange, 4> moves;
-        // 所有移动方式总数 (排除被封闭的棋子))
-        int moveOpts = 0;
-        // 每种方式移动后射箭方式总数 (排除被封闭的棋子))
-        QVector<int> shootOpts;
-        // 所有行棋方式总数 (排除被封闭的棋子)
-        int actionCount = 0;
-
-        // 是否处于官子阶段
-        bool isEndgame() const {
-            return (moves[0].inClosedRegion() || !moves[0].canMove())
-                   && (moves[1].inClosedRegion() || !moves[1].canMove())
-                   && (moves[2].inClosedRegion() || !moves[2].canMove())
-                   && (moves[3].inClosedRegion() || !moves[3].canMove());
-        }
-    };
-
-    struct Weights
-    {
-        // 移动性权重与指数
-        double mobilityWeight;
-        double mobilityExponent;
-
-        // 射箭灵活性权重与指数
-        double shootFlexibilityWeight;
-        double shootExponent;
-
-        // 领地面积权重
-        double territoryWeight;
-
-        // 中心控制权重
-        double centerControlWeight;
-
-        // 棋子分散性权重
-        double dispersionWeight;
-
-        // 构造函数初始化列表
-        Weights() :
-            mobilityWeight(1.0),
-            mobilityExponent(0.5),
-            shootFlexibilityWeight(0.6),
-            shootExponent(0.4),
-            territoryWeight(2.0),
-            centerControlWeight(0.5),
-            dispersionWeight(0.3)
-        {}
-        Weights(double mobilityW, double mobilityE,
-                double shootW, double shootE,
-                double territoryW,
-                double centerW,
-                double dispersionW) :
-            mobilityWeight(mobilityW),
-            mobilityExponent(mobilityE),
-            shootFlexibilityWeight(shootW),
-            shootExponent(shootE),
-            territoryWeight(territoryW),
-            centerControlWeight(centerW),
-            dispersionWeight(dispersionW)
-        {}
-
-        // 结构体 -> QJsonObject
-        QJsonObject toJson() const
-        {
-            QJsonObject obj;
-            obj["mobilityWeight"]          = mobilityWeight;
-            obj["mobilityExponent"]        = mobilityExponent;
-            obj["shootFlexibilityWeight"]  = shootFlexibilityWeight;
-            obj["shootExponent"]           = shootExponent;
-            obj["territoryWeight"]         = territoryWeight;
-            obj["centerControlWeight"]     = centerControlWeight;
-            obj["dispersionWeight"]        = dispersionWeight;
-            return obj;
-        }
-
-        // QJsonObject -> 结构体
-        void fromJson(const QJsonObject &obj)
-        {
-            mobilityWeight          = obj["mobilityWeight"].toDouble();
-            mobilityExponent        = obj["mobilityExponent"].toDouble();
-            shootFlexibilityWeight  = obj["shootFlexibilityWeight"].toDouble();
-            shootExponent           = obj["shootExponent"].toDouble();
-            territoryWeight         = obj["territoryWeight"].toDouble();
-            centerControlWeight     = obj["centerControlWeight"].toDouble();
-            dispersionWeight        = obj["dispersionWeight"].toDouble();
-        }
-    };
+    // 评估函数权重
+    using Weights = EvalWeights;
 
     // 预设权重
     static const Weights EZ_WEIGHTS;
     static const Weights MD_WEIGHTS;
     static const Weights HD_WEIGHTS;
 
-    explicit Bot(Chessboard *chessboard, bool isWhite = false, Weights weights = Weights(), QObject *parent = nullptr);
+    // 官子阶段之前使用的搜索引擎; 官子阶段总是使用回溯求得的走法序列
+    enum class Engine {
+        AlphaBeta, // 迭代加深的 Alpha-Beta 搜索
+        Mcts       // 蒙特卡洛树搜索
+    };
 
-    Weights getWeights() const { return m_weights; }
+    explicit Bot(Chessboard *chessboard, bool isWhite = false, Weights weights = Weights(), QObject *parent = nullptr);
+    ~Bot() override;
+
+    Weights getWeights() const { return m_search.getWeights(); }
+
+    // 每步思考时间(毫秒)
+    static constexpr int DefaultMoveTimeMs = 1500;
+    void setMoveTime(int ms) { m_moveTimeMs = ms; }
+    int moveTime() const { return m_moveTimeMs; }
+
+    // 最近一次搜索得到的主要变例(自AI这一步起双方预期的走法序列), 搜索或后台思考进行中时为空
+    QVector<Move> principalVariation() const;
+
+    // 置换表大小(MB)
+    void setHashSize(int sizeMB) { m_search.setHashSize(sizeMB); }
+    int hashSize() const { return m_search.hashSize(); }
+
+    void setEngine(Engine engine) { m_engine = engine; }
+    Engine engine() const { return m_engine; }
+    // 蒙特卡洛树搜索的模拟方式
+    void setPlayoutPolicy(PlayoutPolicy policy) { m_mcts.setPlayoutPolicy(policy); }
+    PlayoutPolicy playoutPolicy() const { return m_mcts.playoutPolicy(); }
+    // 最近一次蒙特卡洛树搜索的模拟次数与速度
+    const MctsInfo &lastMctsInfo() const { return m_mcts.lastSearchInfo(); }
+
+    // 搜索线程数, 默认单线程
+    void setThreadCount(int count) {
+        m_search.setThreadCount(count);
+        m_mcts.setThreadCount(count);
+    }
+    int threadCount() const { return m_search.threadCount(); }
+    // 多线程时的并行方式, 默认 Lazy SMP
+    void setParallelMode(ParallelMode mode) { m_search.setParallelMode(mode); }
+    ParallelMode parallelMode() const { return m_search.parallelMode(); }
+    // 把皇后移动与射箭拆为两层的半步搜索, 默认关闭
+    void setHalfPlySearch(bool enabled) { m_search.setHalfPlySearch(enabled); }
+    bool halfPlySearch() const { return m_search.halfPlySearch(); }
+    // 选择性搜索(束宽、LMR、无效剪枝)的参数, 默认全宽搜索
+    void setSearchOptions(const SearchOptions &options) { m_search.setOptions(options); }
+    const SearchOptions &searchOptions() const { return m_search.options(); }
+
+    // 是否有搜索正在工作线程中进行
+    bool isSearching() const { return m_searching; }
+
+    // 后台思考: 走完一步后按主要变例预测对手的应着, 在对手思考期间继续搜索预测走法之后的局面
+    // 预测命中时沿用这次搜索(已用的时间计入每步时间), 未命中时立即停止, 置换表中的结果仍可复用
+    // 仅用于 Alpha-Beta 引擎, 默认关闭
+    void setPondering(bool enabled);
+    bool ponderingEnabled() const { return m_ponderEnabled; }
+    // 是否正在后台思考或已思考完毕等待对手走棋
+    bool isPondering() const { return m_pondering; }
+
+signals:
+    // 工作线程完成搜索, 经排队连接回到 Bot 所在线程落子; generation 用于丢弃已取消的搜索结果
+    void searchFinished(quint64 generation);
 
 public slots:
-    // 下一步棋
+    // 在工作线程中开始搜索下一步, 完成后在界面线程落子
+    // 游戏已结束、正在回放或已有搜索在进行时返回 false
     bool makeNextMove();
 
+    // 立即中止正在进行的搜索并丢弃其结果, 同时取消尚未开始的延迟行棋
+    void cancelSearch();
+
     // 重置AI状态
     void reset();
 
 private:
     Chessboard *m_chessboard;
-    Chessboard *m_sandbox; // 沙盒棋盘，用于模拟走法
 
     bool m_isWhite; // 是否为白方AI
     bool m_gameOver; // 游戏是否结束
+    int m_moveTimeMs; // 每步思考时间(毫秒)
+    Engine m_engine; // 官子阶段之前使用的搜索引擎
 
-    // 获取所有可能走法
-    AllMoves getAllMoves(bool inSandbox = false) const;
-    // 获取指定阵营的所有可能走法
-    AllMoves getAllMovesForSide(bool isWhite, bool inSandbox = false) const;
     // 执行一步走法
     bool makeMove(const Move &move);
-
-    // 官子阶段
-    bool m_endgame; // 是否处于官子阶段
-    QVector<Move> m_endgameMoves; // 在官子阶段记录当前棋子的行棋策略
-    QSet<Chessboard::Board> m_endgameVisited; // 记录官子阶段已访问的棋盘状态
-
-    QVector<Move> getEndgameMoves(QPair<int, int> piecePos = {-1, -1}); // 获取官子阶段一个棋子的行棋策略
-    bool makeMoveInEndgame(); // 官子阶段行棋
-
-    bool makeMoveInSandbox(const Move &move, bool skipOpponentTurn = false, bool autoSetTurnState = false); // 在沙盒棋盘上执行一步走法
-    bool reverseMoveInSandbox(const Move &move); // 撤销沙盒棋盘上的一步走法
-    void resetSandbox(); // 重置沙盒棋盘为当前的真实棋盘状态
-
-    // 行棋算法
-    // Minimax算法
-    double evalSandbox(); // 计算当前沙盒棋盘评分
-    Move getBestMove(int depth = 0); // 获取最佳走法
-    // Alpha-Beta 搜索函数
-    // alpha: 当前层最大化玩家已找到的最好值
-    // beta: 当前层最小化玩家已找到的最好值
-    double alphaBeta(int depth, double alpha, double beta, bool maximizingPlayer);
-    // 直接生成所有合法走法列表 (比 getMoveByIndex 更快)
-    QVector<Move> generateLegalMoves(bool forWhite, bool inSandbox) const;
-
-    // 评估函数权重
-    Weights m_weights;
+    // 执行工作线程的搜索结果, 随后开始后台思考
+    void playResult();
+
+    // 工作线程中的搜索
+    std::thread m_worker;
+    std::atomic<bool> m_cancel{false}; // 取消令牌, 搜索定期读取
+    quint64 m_generation = 0; // 每次开始或取消搜索时递增
+    bool m_searching = false;
+    BasicPackedMove<Chessboard::BoardSize> m_result; // 工作线程的搜索结果, 收到 searchFinished 后读取
+    void startSearch(const BasicPosition<Chessboard::BoardSize> &position);
+    void onSearchFinished(quint64 generation);
+
+    // 后台思考
+    bool m_ponderEnabled = false;
+    bool m_pondering = false; // 当前搜索是否为尚未确认的后台思考
+    std::atomic<bool> m_ponderFlag{false}; // 传给搜索的后台思考标志, 预测命中时清零
+    BasicPosition<Chessboard::BoardSize> m_ponderPosition; // 预测的对手应着之后的局面
+    void startPondering();
+    bool ponderHit() const; // 真实棋盘是否为预测的局面
+
+    // 与界面棋盘同尺寸的搜索
+    Search<Chessboard::BoardSize> m_search;
+    Mcts<Chessboard::BoardSize> m_mcts;
 };
 
 #endif // BOT_H
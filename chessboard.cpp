@@ -50,7 +50,7 @@ bool Chessboard::tryToClearSelected()
 
 bool Chessboard::tryToSelect(int row, int col)
 {
-    if (row < 0 || row >= 8 || col < 0 || col >= 8) {
+    if (row < 0 || row >= BoardSize || col < 0 || col >= BoardSize) {
         return false; // 越界
     }
 
@@ -153,28 +153,63 @@ bool Chessboard::shootAt(int row, int col)
     return true;
 }
 
+bool Chessboard::unmakeMove()
+{
+    return undo(1) == 1;
+}
+
+int Chessboard::undo(int count)
+{
+    bool changed = cancelCurrentMove();
+
+    // 行棋历史即撤销栈: 每条记录足以还原棋盘, 回合状态由被移回的棋子颜色决定
+    int undone = 0;
+    while (undone < count && !m_history.isEmpty()) {
+        const Move move = m_history.takeLast();
+
+        // 先移除障碍再移回棋子, 射箭点可能正是原位置
+        m_board[move.shootPos.first][move.shootPos.second] = Cell::Empty;
+        Cell &target = m_board[move.targetPos.first][move.targetPos.second];
+        m_board[move.startPos.first][move.startPos.second] = target;
+        target = Cell::Empty;
+
+        m_turnState = (m_board[move.startPos.first][move.startPos.second] == Cell::White)
+                          ? TurnState::WhiteMove : TurnState::BlackMove;
+        undone++;
+    }
+
+    if (undone > 0) {
+        m_selected = {-1, -1};
+        m_gameOver = false; // 撤销后轮到的一方至少还有刚才那步可走
+        changed = true;
+    }
+    if (changed) emit boardChanged();
+    return undone;
+}
+
+bool Chessboard::cancelCurrentMove()
+{
+    if (m_turnState != TurnState::WhiteShoot
+        && m_turnState != TurnState::BlackShoot) {
+        return false;
+    }
+
+    // 将选中的棋子移回本回合的起始位置
+    m_board[m_currentMove.startPos.first][m_currentMove.startPos.second] = m_board[m_selected.first][m_selected.second];
+    m_board[m_selected.first][m_selected.second] = Cell::Empty;
+    m_turnState = (m_turnState == TurnState::WhiteShoot) ? TurnState::WhiteMove : TurnState::BlackMove;
+    m_selected = {-1, -1};
+    return true;
+}
+
 bool Chessboard::checkGameOver()
 {
     if (m_gameOver) return true;
 
-    bool whiteCanMove = false;
-    bool blackCanMove = false;
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            if (m_board[r][c] == Cell::White) {
-                if (canMove(r, c)) {
-                    whiteCanMove = true;
-                    if (blackCanMove) break;
-                }
-            } else if (m_board[r][c] == Cell::Black) {
-                if (canMove(r, c)) {
-                    blackCanMove = true;
-                    if (whiteCanMove) break;
-                }
-            }
-        }
-        if (whiteCanMove && blackCanMove) break;
-    }
+    // 在位棋盘上以王步邻域与空格的交集判断双方能否移动
+    const BoardPosition position = toPosition();
+    const bool whiteCanMove = position.canMove(true);
+    const bool blackCanMove = position.canMove(false);
 
     if (!whiteCanMove && !blackCanMove) onGameOver(Winner::Tie);
     else if (!whiteCanMove) onGameOver(Winner::Black);
@@ -193,8 +228,9 @@ void Chessboard::startReplay()
         return; // 已经在回放中
     }
 
-    // 拷贝历史记录
+    // 拷贝历史记录, 回放过程中重新记录
     m_replayHistory = m_history;
+    m_history.clear();
 
     // 重置棋盘到初始状态
     reset();
@@ -224,6 +260,27 @@ void Chessboard::stopReplay()
     emit replayFinished();
 }
 
+bool Chessboard::replayStepBack()
+{
+    if (!m_isReplaying || m_replayStep == 0) {
+        return false;
+    }
+
+    m_replayTimer->stop(); // 暂停自动播放
+    undo(1);
+    m_replayStep--;
+
+    emit replayStep(m_replayStep, m_replayHistory.size());
+    return true;
+}
+
+void Chessboard::resumeReplay()
+{
+    if (m_isReplaying && !m_replayTimer->isActive()) {
+        m_replayTimer->start();
+    }
+}
+
 void Chessboard::onReplayTimerTimeout()
 {
     if (m_replayStep >= m_replayHistory.size()) {
@@ -257,8 +314,8 @@ void Chessboard::onReplayTimerTimeout()
 
 bool Chessboard::pathValid(int startRow, int startCol, int endRow, int endCol) const
 {
-    if (startRow < 0 || startRow >= 8 || startCol < 0 || startCol >= 8
-        || endRow < 0 || endRow >= 8 || endCol < 0 || endCol >= 8) {
+    if (startRow < 0 || startRow >= BoardSize || startCol < 0 || startCol >= BoardSize
+        || endRow < 0 || endRow >= BoardSize || endCol < 0 || endCol >= BoardSize) {
         return false; // 越界
     }
 
@@ -307,130 +364,20 @@ void Chessboard::onGameOver(Winner winner)
     emit gameOver(winner);
 }
 
-int Chessboard::getTerritoryArea(int row, int col, bool isWhite, Board *board) const
+int Chessboard::getTerritoryArea(int row, int col, bool isWhite) const
 {
-    // 拷贝棋盘，用于洪水填充
-    Board boardCopy;
-    if (!board) {
-        boardCopy = m_board;
-        board = &boardCopy;
-    }
-
-    if ((*board)[row][col] == (isWhite ? Cell::Black : Cell::White)) {
-        // 遇到敌方棋子，说明不在官子区域
-        return -1;
-    }
-    else if ((*board)[row][col] == Cell::Block) {
-        // 遇到障碍物，停止探索该方向
-        return 0;
-    }
-
-    int area = ((*board)[row][col] == Cell::Empty ? 1 : 0); // 当前空白格子计入面积
-
-    // 当前为空地或己方棋子，标记为已访问
-    (*board)[row][col] = Cell::Block;
-
-    // 向八个方向探索
-    if (row > 0) {
-        int delta = getTerritoryArea(row - 1, col, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (row < 7) {
-        int delta = getTerritoryArea(row + 1, col, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (col > 0) {
-        int delta = getTerritoryArea(row, col - 1, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (col < 7) {
-        int delta = getTerritoryArea(row, col + 1, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (row > 0 && col > 0) {
-        int delta = getTerritoryArea(row - 1, col - 1, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (row > 0 && col < 7) {
-        int delta = getTerritoryArea(row - 1, col + 1, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (row < 7 && col > 0) {
-        int delta = getTerritoryArea(row + 1, col - 1, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    if (row < 7 && col < 7) {
-        int delta = getTerritoryArea(row + 1, col + 1, isWhite, board);
-        if (delta == -1) return -1;
-        area += delta;
-    }
-    return area;
+    // 在位棋盘上做迭代洪水填充
+    return toPosition().getTerritoryArea(BoardPosition::Geometry::squareOf(row, col), isWhite);
 }
 
 MoveRange Chessboard::getMoveRange(int row, int col) const
 {
-    MoveRange range;
-
-    if (row < 0 || row >= 8 || col < 0 || col >= 8) {
-        return range; // 越界
+    if (row < 0 || row >= BoardSize || col < 0 || col >= BoardSize) {
+        return MoveRange(); // 越界
     }
 
-    // 探索八个方向
-    // 向上
-    while (row - range.up - 1 >= 0
-           && m_board[row - range.up - 1][col] == Cell::Empty) {
-        range.up++;
-    }
-    // 向下
-    while (row + range.down + 1 < 8
-           && m_board[row + range.down + 1][col] == Cell::Empty) {
-        range.down++;
-    }
-    // 向左
-    while (col - range.left - 1 >= 0
-            && m_board[row][col - range.left - 1] == Cell::Empty) {
-        range.left++;
-    }
-    // 向右
-    while (col + range.right + 1 < 8
-            && m_board[row][col + range.right + 1] == Cell::Empty) {
-        range.right++;
-    }
-    // 向左上
-    while (row - range.upLeft - 1 >= 0
-            && col - range.upLeft - 1 >= 0
-            && m_board[row - range.upLeft - 1][col - range.upLeft - 1] == Cell::Empty) {
-        range.upLeft++;
-    }
-    // 向右上
-    while (row - range.upRight - 1 >= 0
-            && col + range.upRight + 1 < 8
-            && m_board[row - range.upRight - 1][col + range.upRight + 1] == Cell::Empty) {
-        range.upRight++;
-    }
-    // 向左下
-    while (row + range.downLeft + 1 < 8
-            && col - range.downLeft - 1 >= 0
-            && m_board[row + range.downLeft + 1][col - range.downLeft - 1] == Cell::Empty) {
-        range.downLeft++;
-    }
-    // 向右下
-    while (row + range.downRight + 1 < 8
-            && col + range.downRight + 1 < 8
-            && m_board[row + range.downRight + 1][col + range.downRight + 1] == Cell::Empty) {
-        range.downRight++;
-    }
-
-    range.territoryArea = getTerritoryArea(row, col, m_board[row][col] == Cell::White);
-
-    return range;
+    // 通过位棋盘查表获取八个方向的步数, 并以洪水填充计算领地
+    return toPosition().getMoveRange(BoardPosition::Geometry::squareOf(row, col));
 }
 
 MoveRange Chessboard::getMoveRangeIgnoring(int row, int col, int ignoreRow, int ignoreCol)
@@ -447,33 +394,65 @@ MoveRange Chessboard::getMoveRangeIgnoring(int row, int col, int ignoreRow, int
 
 bool Chessboard::canMove(int row, int col) const
 {
-    if (row < 0 || row >= 8 || col < 0 || col >= 8) {
+    if (row < 0 || row >= BoardSize || col < 0 || col >= BoardSize) {
         return false; // 越界
     }
     // 探索八个方向
     if (row > 0 && m_board[row - 1][col] == Cell::Empty) return true; // 向上
-    if (row < 7 && m_board[row + 1][col] == Cell::Empty) return true; // 向下
+    if (row < BoardSize - 1 && m_board[row + 1][col] == Cell::Empty) return true; // 向下
     if (col > 0 && m_board[row][col - 1] == Cell::Empty) return true; // 向左
-    if (col < 7 && m_board[row][col + 1] == Cell::Empty) return true; // 向右
+    if (col < BoardSize - 1 && m_board[row][col + 1] == Cell::Empty) return true; // 向右
     if (row > 0 && col > 0 && m_board[row - 1][col - 1] == Cell::Empty) return true; // 向左上
-    if (row > 0 && col < 7 && m_board[row - 1][col + 1] == Cell::Empty) return true; // 向右上
-    if (row < 7 && col > 0 && m_board[row + 1][col - 1] == Cell::Empty) return true; // 向左下
-    if (row < 7 && col < 7 && m_board[row + 1][col + 1] == Cell::Empty) return true; // 向右下
+    if (row > 0 && col < BoardSize - 1 && m_board[row - 1][col + 1] == Cell::Empty) return true; // 向右上
+    if (row < BoardSize - 1 && col > 0 && m_board[row + 1][col - 1] == Cell::Empty) return true; // 向左下
+    if (row < BoardSize - 1 && col < BoardSize - 1 && m_board[row + 1][col + 1] == Cell::Empty) return true; // 向右下
 
     return false;
 }
 
 void Chessboard::reset() {
-    m_board = std::array<std::array<Cell, 8>, 8>();
-    m_board[0][2] = Cell::Black;
-    m_board[0][5] = Cell::Black;
-    m_board[2][0] = Cell::Black;
-    m_board[2][7] = Cell::Black;
-    m_board[7][2] = Cell::White;
-    m_board[7][5] = Cell::White;
-    m_board[5][0] = Cell::White;
-    m_board[5][7] = Cell::White;
+    m_board = positionToBoard(BoardPosition::startPosition());
 
     m_selected = {-1, -1};
     m_turnState = TurnState::WhiteMove;
 }
+
+Chessboard::BoardPosition Chessboard::boardToPosition(const Board &board, bool whiteToMove)
+{
+    using Geometry = BoardPosition::Geometry;
+    BoardPosition position;
+    position.whiteToMove = whiteToMove;
+    for (int r = 0; r < BoardSize; r++) {
+        for (int c = 0; c < BoardSize; c++) {
+            switch (board[r][c]) {
+            case Cell::White: position.white |= Geometry::squareBit(Geometry::squareOf(r, c)); break;
+            case Cell::Black: position.black |= Geometry::squareBit(Geometry::squareOf(r, c)); break;
+            case Cell::Block: position.arrows |= Geometry::squareBit(Geometry::squareOf(r, c)); break;
+            case Cell::Empty: break;
+            }
+        }
+    }
+    position.key = position.computeKey();
+    return position;
+}
+
+Chessboard::Board Chessboard::positionToBoard(const BoardPosition &position)
+{
+    using Geometry = BoardPosition::Geometry;
+    Board board = Board();
+    for (int square = 0; square < Geometry::Squares; square++) {
+        const auto bit = Geometry::squareBit(square);
+        Cell &cell = board[Geometry::rowOf(square)][Geometry::colOf(square)];
+        if (position.white & bit) cell = Cell::White;
+        else if (position.black & bit) cell = Cell::Black;
+        else if (position.arrows & bit) cell = Cell::Block;
+    }
+    return board;
+}
+
+Chessboard::BoardPosition Chessboard::toPosition() const
+{
+    return boardToPosition(m_board,
+                           m_turnState == TurnState::WhiteMove
+                               || m_turnState == TurnState::WhiteShoot);
+}
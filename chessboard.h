@@ -4,49 +4,7 @@
 #include <QObject>
 #include <QTimer>
 #include <array>
-
-// 棋盘上某位置棋子可移动范围的数据结构
-struct MoveRange {
-    int up = 0;
-    int down = 0;
-    int left = 0;
-    int right = 0;
-    int upLeft = 0;
-    int upRight = 0;
-    int downLeft = 0;
-    int downRight = 0;
-    int territoryArea = -1; // -1代表未处于官子阶段，否则为官子阶段领地大小
-
-    // 获取走法总数
-    int getTotalMoves() const {
-        return up + down + left + right
-               + upLeft + upRight + downLeft + downRight;
-    }
-
-    bool canMove() const {
-        return getTotalMoves() > 0;
-    }
-
-    bool inClosedRegion() const {
-        return territoryArea >= 0;
-    }
-};
-
-// 一步行棋的数据结构
-struct Move
-{
-    // 原始位置
-    QPair<int, int> startPos = {-1, -1};
-    // 目标位置
-    QPair<int, int> targetPos = {-1, -1};
-    // 射箭位置
-    QPair<int, int> shootPos = {-1, -1};
-
-    // 显式声明默认构造函数和拷贝赋值，让 Clazy 闭嘴
-    Move() = default;
-    Move(const Move&) = default;
-    Move& operator=(const Move&) = default;
-};
+#include "position.h"
 
 class Chessboard : public QObject
 {
@@ -85,8 +43,12 @@ private:
     friend class Bot; // 允许Bot访问私有成员
 
 public:
+    // 棋盘边长
+    static constexpr int BoardSize = 8;
     // 棋盘布局类型
-    using Board = std::array<std::array<Chessboard::Cell, 8>, 8>;
+    using Board = std::array<std::array<Chessboard::Cell, BoardSize>, BoardSize>;
+    // 对应尺寸的位棋盘局面
+    using BoardPosition = BasicPosition<BoardSize>;
 
     // 行棋状态
     Board m_board;
@@ -111,12 +73,21 @@ public:
     bool moveSelectedTo(int row, int col);
     bool shootAt(int row, int col);
 
+    // 撤销操作
+    // 撤销最近一步行棋
+    bool unmakeMove();
+    // 撤销最近 count 步行棋, 返回实际撤销的步数; 未完成的半步(已移动未射箭)会先被还原
+    int undo(int count = 1);
+
     // 检查游戏是否结束
     bool checkGameOver();
+    bool isGameOver() const { return m_gameOver; }
 
     // 回放功能
     void startReplay(); // 开始回放
     void stopReplay();  // 停止回放
+    bool replayStepBack(); // 回放后退一步, 并暂停自动播放
+    void resumeReplay(); // 继续自动播放
     QVector<Move> getReplayHistory() const { return m_replayHistory; }
     bool isReplaying() const { return m_isReplaying; }
     int getReplayStep() const { return m_replayStep; }
@@ -129,6 +100,9 @@ private:
     // 游戏结束处理
     void onGameOver(Winner winner);
 
+    // 还原已移动但未射箭的半步, 返回是否有改动
+    bool cancelCurrentMove();
+
     // 行棋状态
     Move m_currentMove;
     bool m_gameOver; // 游戏是否结束
@@ -141,7 +115,7 @@ private:
 
 public:
     // 获取处于官子阶段的指定棋子领地大小(非官子阶段为-1)
-    int getTerritoryArea(int row, int col, bool isWhite, Board *board = nullptr) const;
+    int getTerritoryArea(int row, int col, bool isWhite) const;
     // 获取指定棋子活动范围
     MoveRange getMoveRange(int row, int col) const;
     // 获取指定棋子活动范围, 忽略某个位置的阻挡
@@ -151,11 +125,19 @@ public:
     // 重置棋盘, 回到初始状态
     void reset();
 
+    // 棋盘布局与位棋盘局面的互相转换
+    static BoardPosition boardToPosition(const Board &board, bool whiteToMove = true);
+    static Board positionToBoard(const BoardPosition &position);
+    // 获取当前棋盘对应的位棋盘局面
+    BoardPosition toPosition() const;
+
 signals:
     // 行棋的信号
     void moveMade(Move move, bool isWhite);
     // 加载棋盘的信号
     void boardLoaded();
+    // 棋盘被撤销等操作整体改变的信号, 每次撤销只发出一次
+    void boardChanged();
     // 游戏结束的信号
     void gameOver(Chessboard::Winner winner);
 
@@ -185,9 +167,8 @@ inline bool operator==(const Chessboard::Board &a,
 
 inline size_t qHash(const Chessboard::Board &b, size_t seed = 0)
 {
-    static_assert(sizeof(Chessboard::Board) == 64);
-    const auto *p = reinterpret_cast<const quint64*>(b.data());
-    return qHashBits(p, sizeof(Chessboard::Board), seed);
+    static_assert(sizeof(Chessboard::Board) == Chessboard::BoardSize * Chessboard::BoardSize);
+    return qHashBits(b.data(), sizeof(Chessboard::Board), seed);
 }
 
 #endif // CHESSBOARD_H
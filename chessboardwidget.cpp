@@ -53,6 +53,8 @@ ChessboardWidget::ChessboardWidget(Chessboard *chessboard, QWidget *parent)
     connect(m_chessboard, &Chessboard::replayStep, this, &ChessboardWidget::onReplayStep);
     connect(m_chessboard, &Chessboard::replayFinished, this, &ChessboardWidget::onReplayFinished);
     connect(m_chessboard, &Chessboard::boardLoaded, this, [this]() { update(); });
+    // 悔棋信号
+    connect(m_chessboard, &Chessboard::boardChanged, this, &ChessboardWidget::onBoardChanged);
 }
 
 void ChessboardWidget::paintEvent(QPaintEvent *event)
@@ -65,9 +67,9 @@ void ChessboardWidget::paintEvent(QPaintEvent *event)
 
     // 计算棋盘尺寸
     m_boardSize = qMin(width(), height()); // 棋盘实际大小(正方形)
-    m_cellSize = m_boardSize / 8; // 每个格子的大小
-    // 调整棋盘大小，使其为8的倍数，避免像素不对齐
-    m_boardSize = m_cellSize * 8;
+    m_cellSize = m_boardSize / Chessboard::BoardSize; // 每个格子的大小
+    // 调整棋盘大小，使其为边长格数的倍数，避免像素不对齐
+    m_boardSize = m_cellSize * Chessboard::BoardSize;
     m_marginX = (width() - m_boardSize) / 2; // 水平边距
     m_marginY = (height() - m_boardSize) / 2; // 垂直边距
 
@@ -75,8 +77,8 @@ void ChessboardWidget::paintEvent(QPaintEvent *event)
     // 绘制深浅交替的格子, 并标明移动范围
     QPair<int, int> selected = m_chessboard->m_selected;
     MoveRange moveRange = m_chessboard->getMoveRange(selected.first, selected.second);
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
+    for (int row = 0; row < Chessboard::BoardSize; row++) {
+        for (int col = 0; col < Chessboard::BoardSize; col++) {
             QRect rect(m_marginX + col * m_cellSize,
                        m_marginY + row * m_cellSize,
                        m_cellSize, m_cellSize);
@@ -119,8 +121,8 @@ void ChessboardWidget::paintEvent(QPaintEvent *event)
     }
 
     // 绘制棋子
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
+    for (int row = 0; row < Chessboard::BoardSize; row++) {
+        for (int col = 0; col < Chessboard::BoardSize; col++) {
             // 动画处理：如果当前格子是动画的目标位置或者射箭位置，则暂时跳过绘制
             if (m_animType != None) {
                 if (row == m_animEndPos.x() && col == m_animEndPos.y()
@@ -272,7 +274,7 @@ void ChessboardWidget::mousePressEvent(QMouseEvent *event)
         int row = boardPos.y() / m_cellSize;
         int col = boardPos.x() / m_cellSize;
         // 点到棋盘外，尝试取消选择
-        if (boardPos.x() < 0 || boardPos.y() < 0 || row >= 8 || col >= 8) {
+        if (boardPos.x() < 0 || boardPos.y() < 0 || row >= Chessboard::BoardSize || col >= Chessboard::BoardSize) {
             m_chessboard->tryToClearSelected();
         }
         else {
@@ -393,6 +395,26 @@ void ChessboardWidget::onGameOver(Chessboard::Winner winner)
     update();
 }
 
+void ChessboardWidget::onBoardChanged()
+{
+    // 停止进行中的动画, 直接显示撤销后的棋盘
+    if (m_animation->state() == QAbstractAnimation::Running) {
+        m_animation->stop();
+    }
+    if (m_celebrationAnim->state() == QAbstractAnimation::Running) {
+        m_celebrationAnim->stop();
+    }
+
+    m_gameOver = m_chessboard->isGameOver() && !m_chessboard->isReplaying();
+    m_animType = None;
+    m_animProgress = 0.0;
+    m_currentAnimMove = Move();
+    m_animStartPos = QPoint(-1, -1);
+    m_animEndPos = QPoint(-1, -1);
+
+    update();
+}
+
 void ChessboardWidget::onReplayStarted()
 {
     // 停止庆祝动画
@@ -29,6 +29,7 @@ private slots:
     void onAnimFinished();
     void onMoveMade(const Move &move, bool isWhite);
     void onGameOver(Chessboard::Winner winner);
+    void onBoardChanged();
 
     // 回放槽函数
     void onReplayStarted();
@@ -298,10 +298,11 @@ QWidget* MainWindow::createGamePage()
         "}"
         );
 
-    // 顶部工具栏（退出/保存/回放按钮）
+    // 顶部工具栏（退出/保存/悔棋/回放按钮）
     QHBoxLayout *toolBar = new QHBoxLayout();
     QPushButton *btnExit = new QPushButton("返回菜单", m_gamePageContainer);
     QPushButton *btnSave = new QPushButton("保存游戏", m_gamePageContainer);
+    m_btnUndo = new QPushButton("悔棋", m_gamePageContainer);
     m_btnReplay = new QPushButton("回放", m_gamePageContainer);
 
     // 初始禁用回放按钮，游戏结束后启用
@@ -309,6 +310,7 @@ QWidget* MainWindow::createGamePage()
 
     toolBar->addWidget(btnExit);
     toolBar->addWidget(btnSave);
+    toolBar->addWidget(m_btnUndo);
     toolBar->addWidget(m_btnReplay);
     toolBar->addStretch();
 
@@ -330,6 +332,7 @@ QWidget* MainWindow::createGamePage()
             || m_chessboard->checkGameOver()
             || m_chessboard->isReplaying()) {
 
+            cancelBotSearches();
             m_stackedWidget->setCurrentIndex(0);
             return;
         }
@@ -343,12 +346,50 @@ QWidget* MainWindow::createGamePage()
 
         if (reply == QMessageBox::Yes) {
             // 用户点击"是"，返回主菜单
+            cancelBotSearches();
             m_stackedWidget->setCurrentIndex(0);
         }
     });
+    connect(m_btnUndo, &QPushButton::clicked, this, [this](){
+        if (!m_chessboard) return;
+
+        // 回放时后退一步并暂停, 可点击回放按钮继续
+        if (m_chessboard->isReplaying()) {
+            if (m_chessboard->replayStepBack()) {
+                m_btnReplay->setDisabled(false);
+            }
+            return;
+        }
+
+        // 已移动未射箭时只还原这半步, 不再撤销历史中的行棋
+        if (m_chessboard->m_turnState == Chessboard::TurnState::WhiteShoot
+            || m_chessboard->m_turnState == Chessboard::TurnState::BlackShoot) {
+            m_chessboard->undo(0);
+            return;
+        }
+
+        // 悔棋至轮到玩家行棋, 人机对战时连同AI的应着一起撤销
+        // 白方先行, 因此历史长度为偶数时轮到白方
+        const int historySize = m_chessboard->m_history.size();
+        for (int size = historySize - 1; size >= 0; size--) {
+            const bool whiteToMove = size % 2 == 0;
+            if (whiteToMove ? m_chessboard->m_whiteIsPlayer : m_chessboard->m_blackIsPlayer) {
+                m_chessboard->undo(historySize - size);
+                m_btnReplay->setDisabled(true);
+                m_gameSaved = false;
+                return;
+            }
+        }
+    });
     connect(m_btnReplay, &QPushButton::clicked, this, [this](){
         if(m_chessboardWidget) {
-            m_chessboard->startReplay();
+            if (m_chessboard->isReplaying()) {
+                // 回放暂停时继续播放
+                m_chessboard->resumeReplay();
+                m_btnReplay->setDisabled(true);
+            } else {
+                m_chessboard->startReplay();
+            }
         }
     });
 
@@ -473,6 +514,9 @@ QWidget* MainWindow::createLoadPage()
         QString fileName = item->text();
         QString savePath = "./saves/" + fileName;
 
+        // 旧的 Bot 可能仍在搜索旧棋盘, 先中止并清理
+        initBots(false, false);
+
         // SaveGame 加载时需要先初始化一个空白棋盘
         initChessboard(true, true);
 
@@ -483,6 +527,7 @@ QWidget* MainWindow::createLoadPage()
             // 获取 Bot
             m_whiteBot = m_saveGame->getBots().first;
             m_blackBot = m_saveGame->getBots().second;
+            configurePondering();
             // 加载成功跳转
             m_stackedWidget->setCurrentIndex(2);
         } else {
@@ -599,6 +644,20 @@ void MainWindow::initBots(bool initWhiteBot, bool initBlackBot, int difficultyWh
             break;
         }
     }
+    configurePondering();
+}
+
+void MainWindow::configurePondering()
+{
+    // 双方都是AI时后台思考会与对方的正式搜索争抢计算资源, 只在人机对局中启用
+    if (m_whiteBot) m_whiteBot->setPondering(!m_blackBot);
+    if (m_blackBot) m_blackBot->setPondering(!m_whiteBot);
+}
+
+void MainWindow::cancelBotSearches()
+{
+    if (m_whiteBot) m_whiteBot->cancelSearch();
+    if (m_blackBot) m_blackBot->cancelSearch();
 }
 
 bool MainWindow::saveGameAsJson()
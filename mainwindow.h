@@ -30,6 +30,7 @@ private:
 
     // 游戏页面控件
     QPushButton *m_btnReplay;
+    QPushButton *m_btnUndo;
 
     // 设置页面控件
     QComboBox *m_comboWhite;
@@ -49,6 +50,8 @@ private:
     // 核心逻辑函数
     void initChessboard(bool whiteIsPlayer, bool blackIsPlayer);
     void initBots(bool initWhiteBot, bool initBlackBot, int difficultyWhite = 1, int difficultyBlack = 1);
+    void cancelBotSearches(); // 中止两个AI正在进行的搜索
+    void configurePondering(); // 人机对局时让AI在玩家思考期间后台思考
     bool saveGameAsJson();
 
     // UI 初始化函数
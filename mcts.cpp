@@ -0,0 +1,259 @@
+#include "mcts.h"
+#include <cmath>
+#include <thread>
+#include <utility>
+
+template <int N>
+Mcts<N>::Mcts(bool isWhite, EvalWeights weights)
+    : m_isWhite{isWhite}
+    , m_weights{weights}
+{
+}
+
+template <int N>
+void Mcts<N>::setArenaSize(int sizeMB)
+{
+    m_arenaMB = qMax(sizeMB, 1);
+    m_nodes.reset(); // 下次搜索时按新大小分配
+}
+
+template <int N>
+typename Mcts<N>::PackedMove Mcts<N>::search(const Position &rootPosition, const MctsLimits &limits)
+{
+    if (!m_nodes) {
+        m_capacity = static_cast<quint32>(static_cast<quint64>(m_arenaMB) * 1024 * 1024 / sizeof(Node));
+        m_nodes = std::make_unique<Node[]>(m_capacity);
+    }
+    while (static_cast<int>(m_workers.size()) < m_threadCount) {
+        auto worker = std::make_unique<Worker>();
+        worker->rng.seed(QRandomGenerator::global()->generate());
+        worker->evaluator = std::make_unique<Search<N>>(m_isWhite, m_weights);
+        worker->moves = std::make_unique<MoveList<N>>();
+        m_workers.push_back(std::move(worker));
+    }
+
+    m_root = rootPosition;
+    m_limits = limits;
+    if (m_limits.playouts == 0 && m_limits.timeMs == 0) m_limits.playouts = DefaultPlayouts;
+    m_info = MctsInfo();
+    m_timer.start();
+    m_stop = false;
+    m_started = 0;
+    m_completed = 0;
+    m_arenaFull = false;
+
+    // 根节点总是立即展开
+    m_nodeCount = 1;
+    Node &rootNode = m_nodes[0];
+    rootNode.move = PackedMove();
+    rootNode.visits = 0;
+    rootNode.value = 0;
+    rootNode.state = Expanding;
+    m_workers[0]->position = m_root;
+    if (!expand(rootNode, *m_workers[0]) || rootNode.childCount == 0) {
+        m_info.timeMs = m_timer.elapsed();
+        return PackedMove();
+    }
+
+    // 调用线程作为第一个工作线程
+    std::vector<std::thread> threads;
+    for (int i = 1; i < m_threadCount; i++) {
+        Worker *worker = m_workers[i].get();
+        threads.emplace_back([this, worker]() { runWorker(*worker); });
+    }
+    runWorker(*m_workers[0]);
+    for (std::thread &thread : threads) thread.join();
+
+    // 选择访问次数最多的走法, 它比平均胜率最高的走法更稳定
+    const Node *children = &m_nodes[rootNode.firstChild];
+    int best = 0;
+    for (int i = 1; i < rootNode.childCount; i++) {
+        if (children[i].visits.load(std::memory_order_relaxed) > children[best].visits.load(std::memory_order_relaxed)) {
+            best = i;
+        }
+    }
+
+    const quint32 visits = children[best].visits;
+    m_info.playouts = m_completed;
+    m_info.timeMs = m_timer.elapsed();
+    m_info.treeNodes = qMin(m_nodeCount.load(), m_capacity);
+    m_info.winRate = visits == 0 ? 0.0 : children[best].value / (visits * ValueScale);
+    return children[best].move;
+}
+
+template <int N>
+void Mcts<N>::runWorker(Worker &worker)
+{
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        const quint64 index = m_started.fetch_add(1, std::memory_order_relaxed);
+        if (m_limits.playouts > 0 && index >= m_limits.playouts) break;
+        // 每 64 次模拟读取一次时钟
+        if (m_limits.timeMs > 0 && (index & 63) == 0 && m_timer.elapsed() >= m_limits.timeMs) break;
+        if (m_limits.cancel && m_limits.cancel->load(std::memory_order_relaxed)) break;
+
+        playout(worker);
+        m_completed.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_stop = true;
+}
+
+template <int N>
+void Mcts<N>::playout(Worker &worker)
+{
+    Position &position = worker.position;
+    position = m_root;
+
+    // 选择: 沿 UCT 得分最高的子节点下降到叶节点, 沿途立即增加访问次数
+    int length = 0;
+    quint32 index = 0;
+    worker.path[length++] = index;
+    m_nodes[0].visits.fetch_add(1, std::memory_order_relaxed);
+    while (true) {
+        Node &node = m_nodes[index];
+        quint8 state = node.state.load(std::memory_order_acquire);
+
+        // 展开: 访问次数足够的叶节点由第一个抢到它的线程展开
+        if (state == Leaf && node.visits.load(std::memory_order_relaxed) >= ExpandVisits
+            && !m_arenaFull.load(std::memory_order_relaxed)) {
+            quint8 expected = Leaf;
+            if (node.state.compare_exchange_strong(expected, Expanding, std::memory_order_acquire)) {
+                expand(node, worker);
+            }
+            state = node.state.load(std::memory_order_acquire);
+        }
+        if (state != Expanded || node.childCount == 0) break;
+
+        index = selectChild(node, index == 0);
+        Node &child = m_nodes[index];
+        child.visits.fetch_add(1, std::memory_order_relaxed);
+        position.make(child.move);
+        worker.path[length++] = index;
+    }
+
+    // 模拟, 然后沿路径回传收益: 每个节点记录走出它的一方(即其父节点的行棋方)的收益
+    const double whiteWins = simulate(worker);
+    bool moverIsWhite = m_root.whiteToMove;
+    for (int i = 1; i < length; i++) {
+        const double reward = moverIsWhite ? whiteWins : 1.0 - whiteWins;
+        m_nodes[worker.path[i]].value.fetch_add(static_cast<quint64>(reward * ValueScale), std::memory_order_relaxed);
+        moverIsWhite = !moverIsWhite;
+    }
+}
+
+template <int N>
+bool Mcts<N>::expand(Node &node, Worker &worker)
+{
+    // 以打乱的顺序排列子节点, 避免未访问的子节点总是按生成顺序被选中
+    MoveList<N> &moves = *worker.moves;
+    moves.clear();
+    MoveGenerator<N> generator(worker.position, worker.position.pieces(worker.position.whiteToMove));
+    PackedMove move;
+    while (generator.next(move)) moves.append(move);
+    for (int i = moves.size() - 1; i > 0; i--) {
+        std::swap(moves[i], moves[worker.rng.bounded(i + 1)]);
+    }
+
+    const quint32 count = static_cast<quint32>(moves.size());
+    const quint32 first = m_nodeCount.fetch_add(count, std::memory_order_relaxed);
+    if (static_cast<quint64>(first) + count > m_capacity) {
+        m_arenaFull = true;
+        node.state.store(Leaf, std::memory_order_release);
+        return false;
+    }
+
+    for (quint32 i = 0; i < count; i++) {
+        Node &child = m_nodes[first + i];
+        child.move = moves[i];
+        child.visits.store(0, std::memory_order_relaxed);
+        child.value.store(0, std::memory_order_relaxed);
+        child.firstChild = 0;
+        child.childCount = 0;
+        child.state.store(Leaf, std::memory_order_relaxed);
+    }
+    node.firstChild = first;
+    node.childCount = static_cast<quint16>(count);
+    node.state.store(Expanded, std::memory_order_release);
+    return true;
+}
+
+template <int N>
+quint32 Mcts<N>::selectChild(const Node &node, bool isRoot) const
+{
+    const quint32 parentVisits = node.visits.load(std::memory_order_relaxed);
+    const double logVisits = std::log(static_cast<double>(qMax<quint32>(parentVisits, 1)));
+
+    // 子节点以父节点的行棋方为视角, 与父节点自身记录的收益视角相反
+    double parentRate = 0.5;
+    if (!isRoot && parentVisits > 0) {
+        parentRate = 1.0 - node.value.load(std::memory_order_relaxed) / (parentVisits * ValueScale);
+    }
+    const double firstPlay = qMax(parentRate - FirstPlayReduction, 0.0);
+
+    quint32 best = node.firstChild;
+    double bestScore = -1.0;
+    for (quint32 i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+        const Node &child = m_nodes[i];
+        const quint32 visits = child.visits.load(std::memory_order_relaxed);
+        const double rate = visits == 0 ? firstPlay
+                                        : child.value.load(std::memory_order_relaxed) / (visits * ValueScale);
+        const double score = rate + Exploration * std::sqrt(logVisits / (visits + 1));
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <int N>
+double Mcts<N>::simulate(Worker &worker)
+{
+    Position &position = worker.position;
+    PackedMove move;
+
+    // 无路可走的一方判负
+    if (m_policy == PlayoutPolicy::Random) {
+        while (randomMove(position, worker.rng, move)) position.make(move);
+        return position.whiteToMove ? 0.0 : 1.0;
+    }
+
+    for (int i = 0; i < EvalPlayoutPlies; i++) {
+        if (!randomMove(position, worker.rng, move)) return position.whiteToMove ? 0.0 : 1.0;
+        position.make(move);
+    }
+    // 评分以本方为视角, 经 logistic 函数换算为本方胜率
+    const double score = worker.evaluator->evaluate(position);
+    const double rate = 1.0 / (1.0 + std::exp(-EvalSharpness * score));
+    return m_isWhite ? rate : 1.0 - rate;
+}
+
+template <int N>
+bool Mcts<N>::randomMove(const Position &position, QRandomGenerator &rng, PackedMove &move) const
+{
+    using Geometry = BoardGeometry<N>;
+    const Bitboard empty = position.empty();
+
+    // 在能移动的棋子中随机选一个, 再依次随机选落点与射箭点
+    // 各走法的概率并不完全相同, 对模拟而言足够
+    std::array<int, 4> movable;
+    int count = 0;
+    Bitboard pieces = position.pieces(position.whiteToMove);
+    while (pieces) {
+        const int square = popLsb(pieces);
+        if (queenReach<N>(square, empty)) movable[count++] = square;
+    }
+    if (count == 0) return false;
+
+    auto pick = [&rng](Bitboard squares) {
+        for (int skip = rng.bounded(popCount(squares)); skip > 0; skip--) popLsb(squares);
+        return lsbIndex(squares);
+    };
+    const int from = movable[rng.bounded(count)];
+    const int to = pick(queenReach<N>(from, empty));
+    const int arrow = pick(queenReach<N>(to, empty | Geometry::squareBit(from)));
+    move = PackedMove(from, to, arrow);
+    return true;
+}
+
+template class Mcts<8>;
+template class Mcts<10>;
@@ -0,0 +1,147 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "search.h"
+
+// 蒙特卡洛树搜索的模拟方式
+enum class PlayoutPolicy
+{
+    Random,    // 双方随机行棋直到一方无路可走, 以胜负为结果
+    EvalGuided // 随机行棋几步后以评估函数的评分换算胜率
+};
+
+// 单次蒙特卡洛树搜索的限制: 达到模拟次数或用完时间预算时停止, 均为 0 时以默认模拟次数为限
+struct MctsLimits
+{
+    quint64 playouts = 0; // 模拟次数上限
+    qint64 timeMs = 0;    // 时间预算(毫秒)
+    const std::atomic<bool> *cancel = nullptr; // 取消令牌, 由其他线程置位后搜索尽快中止
+};
+
+// 最近一次蒙特卡洛树搜索的结果信息
+struct MctsInfo
+{
+    quint64 playouts = 0;  // 完成的模拟次数(所有线程合计)
+    qint64 timeMs = 0;     // 总耗时(毫秒)
+    quint64 treeNodes = 0; // 树中已分配的节点数
+    double winRate = 0.0;  // 所选走法的平均胜率(本方视角)
+
+    double playoutsPerSecond() const { return timeMs == 0 ? 0.0 : playouts * 1000.0 / timeMs; }
+};
+
+// N x N 棋盘上的蒙特卡洛树搜索(UCT), 作为 Alpha-Beta 之外的另一种AI
+// 节点从预先分配的节点池中按块分配: 一个节点被访问足够多次后才生成走法, 一次性分配全部子节点
+// 多个线程共享同一棵树(树并行): 下降时立即增加沿途节点的访问次数而暂不计入收益, 相当于一次虚拟的失败,
+// 使其他线程倾向于选择别的分支; 模拟结束后再补上真实收益
+// 成员函数定义于 mcts.cpp, 在其中显式实例化 8x8 与 10x10
+template <int N>
+class Mcts
+{
+public:
+    using Bitboard = BitboardOf<N>;
+    using Position = BasicPosition<N>;
+    using PackedMove = BasicPackedMove<N>;
+
+    static constexpr int DefaultArenaMB = 32;
+    static constexpr quint64 DefaultPlayouts = 20000;
+
+    explicit Mcts(bool isWhite = false, EvalWeights weights = EvalWeights());
+
+    // 节点池大小(MB), 用满后树不再扩展, 继续从现有叶节点模拟
+    void setArenaSize(int sizeMB);
+    int arenaSize() const { return m_arenaMB; }
+
+    // 搜索线程数, 包括调用 search 的线程
+    void setThreadCount(int count) { m_threadCount = qMax(count, 1); }
+    int threadCount() const { return m_threadCount; }
+
+    void setPlayoutPolicy(PlayoutPolicy policy) { m_policy = policy; }
+    PlayoutPolicy playoutPolicy() const { return m_policy; }
+
+    // 从 root 出发搜索, 返回访问次数最多的走法; 无棋可走时返回空走法
+    PackedMove search(const Position &root, const MctsLimits &limits);
+    // 最近一次搜索的模拟次数、耗时与树的规模
+    const MctsInfo &lastSearchInfo() const { return m_info; }
+
+private:
+    // UCT 探索系数
+    static constexpr double Exploration = 0.7;
+    // 未访问子节点的估值取父节点平均胜率减去此值, 使好的分支不必等所有兄弟都被访问一次就能加深
+    static constexpr double FirstPlayReduction = 0.1;
+    // 叶节点被访问到此次数才展开
+    static constexpr quint32 ExpandVisits = 8;
+    // 收益的定点数比例: 一次胜利记为 ValueScale
+    static constexpr double ValueScale = 65536.0;
+    // EvalGuided 模式下评估前随机行棋的步数
+    static constexpr int EvalPlayoutPlies = 2;
+    // 评分换算胜率时 logistic 函数的斜率, 按评估函数的实际评分范围标定:
+    // bench 局面的根节点评分在 ±0.1 左右, 随机对局中叶节点评分的绝对值中位数约 0.025、90% 分位约 0.16;
+    // 以深度1自我对弈的胜负拟合, 评分绝对值 0.1 以上时对应的斜率约为 7~9
+    // 取 10 时 ±0.1 换算为 27%~73% 的胜率, 90% 分位约为 83%(斜率 3 时只有 47%~53%)
+    static constexpr double EvalSharpness = 10.0;
+
+    enum NodeState : quint8 {
+        Leaf,      // 尚未展开
+        Expanding, // 某个线程正在展开, 其他线程暂时把它当作叶节点
+        Expanded   // 子节点已就绪; 没有子节点时为终局
+    };
+
+    struct Node
+    {
+        PackedMove move; // 到达该节点的走法
+        std::atomic<quint32> visits{0}; // 访问次数, 下降时即增加
+        std::atomic<quint64> value{0};  // 累计收益(定点数), 以走出 move 的一方为视角
+        quint32 firstChild = 0; // 子节点在节点池中的起始位置, 展开完成后才有效
+        quint16 childCount = 0;
+        std::atomic<quint8> state{Leaf};
+    };
+
+    // 每个线程各自的模拟局面与随机数
+    struct Worker
+    {
+        Position position;
+        QRandomGenerator rng;
+        std::unique_ptr<Search<N>> evaluator; // EvalGuided 模式下评估局面
+        std::unique_ptr<MoveList<N>> moves;   // 展开节点时的走法缓冲区
+        std::array<quint32, BoardGeometry<N>::Squares + 1> path; // 本次下降经过的节点
+    };
+
+    void runWorker(Worker &worker);
+    void playout(Worker &worker);
+    bool expand(Node &node, Worker &worker); // 展开节点, 节点池已满时返回 false
+    quint32 selectChild(const Node &node, bool isRoot) const;
+    double simulate(Worker &worker); // 从 worker.position 模拟到底, 返回白方的胜率
+    bool randomMove(const Position &position, QRandomGenerator &rng, PackedMove &move) const;
+
+    bool m_isWhite; // 是否为白方AI
+    EvalWeights m_weights;
+    PlayoutPolicy m_policy = PlayoutPolicy::Random;
+    int m_threadCount = 1;
+
+    // 节点池, 第一次搜索时分配
+    int m_arenaMB = DefaultArenaMB;
+    std::unique_ptr<Node[]> m_nodes;
+    quint32 m_capacity = 0;
+    std::atomic<quint32> m_nodeCount{0};
+    std::atomic<bool> m_arenaFull{false};
+
+    // 搜索控制
+    Position m_root;
+    MctsLimits m_limits;
+    QElapsedTimer m_timer;
+    std::atomic<bool> m_stop{false};
+    std::atomic<quint64> m_started{0};   // 已开始的模拟次数
+    std::atomic<quint64> m_completed{0}; // 已完成的模拟次数
+    MctsInfo m_info;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+extern template class Mcts<8>;
+extern template class Mcts<10>;
+
+#endif // MCTS_H
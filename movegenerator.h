@@ -0,0 +1,61 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include "position.h"
+
+// 分阶段的惰性走法生成器
+// 依次枚举棋子、落点与射箭点: 落点在取到该棋子时才计算, 射箭范围在取到该落点时才展开.
+// 搜索在剪枝后直接丢弃生成器即可, 未取到的落点与射箭点不产生任何开销.
+// 生成器在构造时记下空格, 迭代期间局面可以被 make/unmake, 但每次调用 next 前须已还原
+template <int N>
+class MoveGenerator
+{
+public:
+    using Geometry = BoardGeometry<N>;
+    using Bitboard = BitboardOf<N>;
+    using PackedMove = BasicPackedMove<N>;
+
+    // pieces 为需要生成走法的棋子, 通常为行棋方的全部或部分棋子
+    MoveGenerator(const BasicPosition<N> &position, Bitboard pieces)
+        : m_empty{position.empty()}
+        , m_pieces{pieces}
+    {}
+
+    // 取出下一步走法, 已全部取完时返回 false
+    bool next(PackedMove &move) {
+        while (!m_shoots) {
+            // 当前棋子的落点用尽, 换下一个棋子
+            while (!m_targets) {
+                if (!m_pieces) return false;
+                m_from = popLsb(m_pieces);
+                m_targets = queenReach<N>(m_from, m_empty);
+                // 棋子移动后原位置视为空
+                m_shootEmpty = m_empty | Geometry::squareBit(m_from);
+            }
+            // 取下一个落点并展开其射箭范围
+            m_to = popLsb(m_targets);
+            m_shoots = queenReach<N>(m_to, m_shootEmpty);
+        }
+        move = PackedMove(m_from, m_to, popLsb(m_shoots));
+        return true;
+    }
+
+    // 走法对生成器的棋子与局面是否合法, 用于校验来自置换表、杀手表等的走法, 须在开始生成前调用
+    bool isLegal(PackedMove move) const {
+        const Bitboard from = Geometry::squareBit(move.from());
+        if (!(m_pieces & from)) return false;
+        if (!(queenReach<N>(move.from(), m_empty) & Geometry::squareBit(move.to()))) return false;
+        return static_cast<bool>(queenReach<N>(move.to(), m_empty | from) & Geometry::squareBit(move.arrow()));
+    }
+
+private:
+    Bitboard m_empty;        // 生成开始时的空格
+    Bitboard m_pieces;       // 尚未处理的棋子
+    Bitboard m_targets{};    // 当前棋子尚未处理的落点
+    Bitboard m_shoots{};     // 当前落点尚未处理的射箭点
+    Bitboard m_shootEmpty{}; // 当前棋子移动后的空格
+    int m_from = 0;
+    int m_to = 0;
+};
+
+#endif // MOVEGENERATOR_H
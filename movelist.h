@@ -0,0 +1,67 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <array>
+#include "position.h"
+
+// 固定容量的走法列表, 容量为最大分支数的上界: 四个棋子各自的落点数乘以每个落点的射箭点数
+// 8x8 为 4 * 27 * 27, 10x10 为 4 * 35 * 35
+template <int N>
+class MoveList
+{
+public:
+    using PackedMove = BasicPackedMove<N>;
+    static constexpr int Capacity = 4 * maxQueenMoves<N>() * maxQueenMoves<N>();
+
+    void clear() { m_size = 0; }
+    void append(PackedMove move) { m_moves[m_size++] = move; }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    PackedMove &operator[](int index) { return m_moves[index]; }
+    PackedMove operator[](int index) const { return m_moves[index]; }
+
+    PackedMove *begin() { return m_moves.data(); }
+    PackedMove *end() { return m_moves.data() + m_size; }
+    const PackedMove *begin() const { return m_moves.data(); }
+    const PackedMove *end() const { return m_moves.data() + m_size; }
+
+private:
+    std::array<PackedMove, Capacity> m_moves;
+    int m_size = 0;
+};
+
+// 搜索栈: 每层搜索各占一个走法列表, 整个搜索过程中反复使用而不再分配内存
+// 每层至少射出一支箭, 因此层数不超过格子数
+// 每个搜索线程持有各自的搜索栈
+template <int N>
+class SearchStack
+{
+public:
+    static constexpr int MaxPly = BoardGeometry<N>::Squares;
+
+    struct Ply
+    {
+        MoveList<N> moves; // 该层的走法
+        std::array<int, MoveList<N>::Capacity> scores; // 对应走法的排序得分
+        std::array<BasicPackedMove<N>, 2> killers{}; // 杀手走法: 该层最近引起剪枝的两步
+        BasicPackedMove<N> currentMove; // 该层正在搜索的走法, 供下一层查找反制走法
+        std::array<BasicPackedMove<N>, MaxPly> pv; // 从该层开始的主要变例
+        int pvLength = 0;
+    };
+
+    MoveList<N> &moves(int ply) { return m_plies[ply].moves; }
+    Ply &ply(int ply) { return m_plies[ply]; }
+
+    // 清空杀手走法, 每次搜索开始时调用
+    void clearKillers() {
+        for (Ply &ply : m_plies) ply.killers = {};
+    }
+
+private:
+
+    std::array<Ply, MaxPly> m_plies;
+};
+
+#endif // MOVELIST_H
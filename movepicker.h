@@ -0,0 +1,213 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <algorithm>
+#include "movegenerator.h"
+#include "movelist.h"
+
+// 历史启发表: 分别记录每一方的 "起点-落点" 与 "落点-射箭点" 引起剪枝的累计得分
+// 一步走法的历史得分为两部分之和, 避免为 起点 x 落点 x 射箭点 的组合分配过大的表
+template <int N>
+class HistoryTable
+{
+public:
+    using PackedMove = BasicPackedMove<N>;
+    static constexpr int Squares = BoardGeometry<N>::Squares;
+
+    HistoryTable() { clear(); }
+
+    void clear() {
+        for (auto &side : m_queen) side.fill(0);
+        for (auto &side : m_arrow) side.fill(0);
+    }
+
+    // 新的搜索开始时衰减旧的得分, 让近期的剪枝信息占主导
+    void age() {
+        for (auto &side : m_queen) for (int &value : side) value /= 2;
+        for (auto &side : m_arrow) for (int &value : side) value /= 2;
+    }
+
+    int score(bool isWhite, PackedMove move) const {
+        return queenScore(isWhite, move.from(), move.to()) + arrowScore(isWhite, move.to(), move.arrow());
+    }
+    // 半步搜索中分别为皇后步与射箭排序
+    int queenScore(bool isWhite, int from, int to) const { return m_queen[isWhite][from * Squares + to]; }
+    int arrowScore(bool isWhite, int to, int arrow) const { return m_arrow[isWhite][to * Squares + arrow]; }
+
+    // 走法引起剪枝时按剩余深度的平方加分
+    void reward(bool isWhite, PackedMove move, int depth) {
+        rewardQueen(isWhite, move.from(), move.to(), depth);
+        rewardArrow(isWhite, move.to(), move.arrow(), depth);
+    }
+    void rewardQueen(bool isWhite, int from, int to, int depth) {
+        int &queen = m_queen[isWhite][from * Squares + to];
+        queen = qMin(queen + depth * depth, MaxScore);
+    }
+    void rewardArrow(bool isWhite, int to, int arrow, int depth) {
+        int &value = m_arrow[isWhite][to * Squares + arrow];
+        value = qMin(value + depth * depth, MaxScore);
+    }
+
+private:
+    static constexpr int MaxScore = 1 << 24;
+
+    std::array<std::array<int, Squares * Squares>, 2> m_queen; // [行棋方][起点 * 格子数 + 落点]
+    std::array<std::array<int, Squares * Squares>, 2> m_arrow; // [行棋方][落点 * 格子数 + 射箭点]
+};
+
+// 反制走法表: 以对方上一步的落点与射箭点为索引, 记录最近一次针对它引起剪枝的应着
+template <int N>
+class CounterMoveTable
+{
+public:
+    using PackedMove = BasicPackedMove<N>;
+    static constexpr int Squares = BoardGeometry<N>::Squares;
+
+    void clear() { m_moves.fill(PackedMove()); }
+
+    PackedMove get(PackedMove previous) const {
+        return previous.isNull() ? PackedMove() : m_moves[previous.to() * Squares + previous.arrow()];
+    }
+    void set(PackedMove previous, PackedMove move) {
+        if (!previous.isNull()) m_moves[previous.to() * Squares + previous.arrow()] = move;
+    }
+
+private:
+    std::array<PackedMove, Squares * Squares> m_moves{};
+};
+
+// 分阶段的走法排序器, 依次给出:
+// 1. 置换表走法  2. 本层的两个杀手走法  3. 对方上一步的反制走法  4. 其余走法
+// 前三个阶段的走法只需校验合法性, 不生成全部走法; 在它们引起剪枝时第4阶段完全不会执行
+// 第4阶段保持惰性: 先生成全部皇后步(每个棋子的落点)并按历史表的 "起点-落点" 得分排序,
+// 轮到某个皇后步时才展开它的射箭点并按 "落点-射箭点" 得分排序; 剪枝后其余皇后步的射箭点不再展开
+template <int N>
+class MovePicker
+{
+public:
+    using PackedMove = BasicPackedMove<N>;
+    using Bitboard = BitboardOf<N>;
+    using Geometry = BoardGeometry<N>;
+
+    // moves 与 scores 为本层的缓冲区, 第4阶段在其中存放已展开的射箭点
+    MovePicker(const BasicPosition<N> &position, Bitboard pieces, bool isWhite,
+               PackedMove hashMove, const std::array<PackedMove, 2> &killers, PackedMove counterMove,
+               const HistoryTable<N> &history, MoveList<N> &moves, std::array<int, MoveList<N>::Capacity> &scores)
+        : m_generator{position, pieces}
+        , m_empty{position.empty()}
+        , m_pieces{pieces}
+        , m_isWhite{isWhite}
+        , m_history{history}
+        , m_moves{moves}
+        , m_scores{scores}
+    {
+        m_moves.clear();
+        // 特殊走法按顺序去重并校验合法性
+        for (PackedMove move : {hashMove, killers[0], killers[1], counterMove}) {
+            if (move.isNull() || !m_generator.isLegal(move)) continue;
+            if (isSpecial(move)) continue;
+            m_special[m_specialCount++] = move;
+        }
+    }
+
+    // 取出下一步走法, 已全部取完时返回 false
+    bool next(PackedMove &move) {
+        if (m_specialIndex < m_specialCount) {
+            move = m_special[m_specialIndex++];
+            return true;
+        }
+
+        if (!m_stepsGenerated) generateSteps();
+        // 当前皇后步的射箭点取完后展开下一个皇后步; 已全部展开时没有后续
+        while (m_index >= m_moves.size()) {
+            if (m_expandedAll || m_stepIndex >= m_stepCount) return false;
+            m_moves.clear();
+            m_index = 0;
+            appendArrows(m_steps[m_stepIndex++]);
+        }
+        move = m_moves[m_index++];
+        return true;
+    }
+
+    // 提前展开其余全部走法, 此后 next() 不再读取历史表, 可以由其他线程取用
+    void generateAll() {
+        if (m_expandedAll) return;
+        if (!m_stepsGenerated) generateSteps();
+        while (m_stepIndex < m_stepCount) appendArrows(m_steps[m_stepIndex++]);
+        m_expandedAll = true;
+    }
+
+private:
+    static constexpr int MaxSteps = 4 * maxQueenMoves<N>();
+
+    bool isSpecial(PackedMove move) const {
+        return std::find(m_special.begin(), m_special.begin() + m_specialCount, move) != m_special.begin() + m_specialCount;
+    }
+
+    // 生成全部皇后步并按得分降序排序, 得分相同时保持生成顺序
+    void generateSteps() {
+        m_stepsGenerated = true;
+        Bitboard pieces = m_pieces;
+        while (pieces) {
+            const int from = popLsb(pieces);
+            Bitboard targets = queenReach<N>(from, m_empty);
+            while (targets) {
+                const int to = popLsb(targets);
+                m_steps[m_stepCount] = PackedMove(from, to, from);
+                m_stepScores[m_stepCount] = m_history.queenScore(m_isWhite, from, to);
+                m_stepCount++;
+            }
+        }
+        insertionSort(m_steps.data(), m_stepScores.data(), 0, m_stepCount);
+    }
+
+    // 把皇后步 step 的全部射箭点(除去特殊走法)按得分降序追加到缓冲区末尾
+    void appendArrows(PackedMove step) {
+        const int first = m_moves.size();
+        Bitboard shoots = queenReach<N>(step.to(), m_empty | Geometry::squareBit(step.from()));
+        while (shoots) {
+            const PackedMove move(step.from(), step.to(), popLsb(shoots));
+            if (isSpecial(move)) continue;
+            m_scores[m_moves.size()] = m_history.arrowScore(m_isWhite, move.to(), move.arrow());
+            m_moves.append(move);
+        }
+        insertionSort(m_moves.begin(), m_scores.data(), first, m_moves.size());
+    }
+
+    // 对 [first, last) 按得分降序插入排序, 得分相同时保持原顺序; 每次最多一百多个元素
+    static void insertionSort(PackedMove *moves, int *scores, int first, int last) {
+        for (int i = first + 1; i < last; i++) {
+            const PackedMove move = moves[i];
+            const int score = scores[i];
+            int j = i;
+            for (; j > first && scores[j - 1] < score; j--) {
+                moves[j] = moves[j - 1];
+                scores[j] = scores[j - 1];
+            }
+            moves[j] = move;
+            scores[j] = score;
+        }
+    }
+
+    MoveGenerator<N> m_generator; // 只用于校验特殊走法
+    Bitboard m_empty;
+    Bitboard m_pieces;
+    bool m_isWhite;
+    const HistoryTable<N> &m_history;
+    MoveList<N> &m_moves;
+    std::array<int, MoveList<N>::Capacity> &m_scores;
+
+    std::array<PackedMove, 4> m_special{}; // 置换表、杀手与反制走法
+    int m_specialCount = 0;
+    int m_specialIndex = 0;
+
+    std::array<PackedMove, MaxSteps> m_steps; // 皇后步, 射箭点记为起点, 不使用
+    std::array<int, MaxSteps> m_stepScores;
+    int m_stepCount = 0;
+    int m_stepIndex = 0; // 下一个要展开的皇后步
+    bool m_stepsGenerated = false;
+    bool m_expandedAll = false;
+    int m_index = 0; // 缓冲区中下一个要取出的走法
+};
+
+#endif // MOVEPICKER_H
@@ -0,0 +1,173 @@
+// 走法生成的正确性与速度基准
+// 用法:
+//   perft [--fen <局面串>] [--divide] <深度>    统计指定局面(默认 8x8 开局)的叶子节点数
+//   perft --suite <参考局面文件> [--max-depth <深度>]  逐个校验参考局面的已知节点数
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include "movegenerator.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// 行棋方全部走法的数量, 只计数不生成
+template <int N>
+quint64 countMoves(const BasicPosition<N> &position)
+{
+    const BitboardOf<N> emptySquares = position.empty();
+    quint64 count = 0;
+    BitboardOf<N> pieces = position.pieces(position.whiteToMove);
+    while (pieces) {
+        const int from = popLsb(pieces);
+        const BitboardOf<N> shootEmpty = emptySquares | BoardGeometry<N>::squareBit(from);
+        count += countSlides<N>(queenReach<N>(from, emptySquares), shootEmpty);
+    }
+    return count;
+}
+
+// 从 position 出发 depth 层的叶子节点数
+template <int N>
+quint64 perft(BasicPosition<N> &position, int depth)
+{
+    if (depth == 0) return 1;
+    // 最后一层直接计数, 不必逐个执行走法
+    if (depth == 1) return countMoves(position);
+
+    quint64 nodes = 0;
+    MoveGenerator<N> generator(position, position.pieces(position.whiteToMove));
+    BasicPackedMove<N> move;
+    while (generator.next(move)) {
+        position.make(move);
+        nodes += perft(position, depth - 1);
+        position.unmake(move);
+    }
+    return nodes;
+}
+
+// 分别列出每个根节点走法之下的节点数
+template <int N>
+quint64 divide(BasicPosition<N> &position, int depth)
+{
+    quint64 nodes = 0;
+    MoveGenerator<N> generator(position, position.pieces(position.whiteToMove));
+    BasicPackedMove<N> move;
+    while (generator.next(move)) {
+        position.make(move);
+        const quint64 count = perft(position, depth - 1);
+        position.unmake(move);
+        out() << move.toString() << ": " << count << Qt::endl;
+        nodes += count;
+    }
+    return nodes;
+}
+
+// 对一个局面执行 perft 并输出耗时与速度, 局面串非法时返回 false
+template <int N>
+bool runPerft(const QString &fen, int depth, bool divideMode, quint64 &nodes)
+{
+    BasicPosition<N> position;
+    if (!BasicPosition<N>::fromFen(fen, position)) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    nodes = (divideMode && depth > 0) ? divide(position, depth) : perft(position, depth);
+    const qint64 elapsed = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+    out() << "depth " << depth << "  nodes " << nodes
+          << "  time " << elapsed / 1000000 << " ms"
+          << "  nps " << static_cast<quint64>(nodes * 1e9 / elapsed) << Qt::endl;
+    return true;
+}
+
+// 按棋盘尺寸分派到对应的模板实例
+bool runPerft(const QString &fen, int depth, bool divideMode, quint64 &nodes)
+{
+    switch (fenBoardSize(fen)) {
+    case 8: return runPerft<8>(fen, depth, divideMode, nodes);
+    case 10: return runPerft<10>(fen, depth, divideMode, nodes);
+    }
+    return false;
+}
+
+// 参考局面文件: 每行为 "局面串;D1 节点数;D2 节点数;...", 以 # 开头的行为注释
+int runSuite(const QString &fileName, int maxDepth)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        out() << "cannot open " << fileName << Qt::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        const QStringList fields = line.split(';');
+        const QString fen = fields[0].trimmed();
+        out() << fen << Qt::endl;
+        for (int i = 1; i < fields.size(); i++) {
+            const QStringList entry = fields[i].trimmed().split(' ', Qt::SkipEmptyParts);
+            if (entry.size() != 2 || !entry[0].startsWith('D')) continue;
+            const int depth = entry[0].mid(1).toInt();
+            const quint64 expected = entry[1].toULongLong();
+            if (depth > maxDepth) continue;
+
+            quint64 nodes = 0;
+            if (!runPerft(fen, depth, false, nodes)) {
+                out() << "  invalid position" << Qt::endl;
+                failures++;
+                break;
+            }
+            if (nodes != expected) {
+                out() << "  FAIL: expected " << expected << Qt::endl;
+                failures++;
+            }
+        }
+    }
+
+    out() << (failures == 0 ? "all passed" : QString::number(failures) + " failed") << Qt::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Amazons move generator perft");
+    parser.addHelpOption();
+    QCommandLineOption fenOption("fen", "Position to search (default: 8x8 start).", "fen");
+    QCommandLineOption divideOption("divide", "Print the node count below each root move.");
+    QCommandLineOption suiteOption("suite", "Check every position in a reference file.", "file");
+    QCommandLineOption maxDepthOption("max-depth", "Deepest suite entry to check (default: 3).", "depth", "3");
+    parser.addOptions({fenOption, divideOption, suiteOption, maxDepthOption});
+    parser.addPositionalArgument("depth", "Search depth.");
+    parser.process(app);
+
+    if (parser.isSet(suiteOption)) {
+        return runSuite(parser.value(suiteOption), parser.value(maxDepthOption).toInt());
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) parser.showHelp(1);
+
+    const QString fen = parser.isSet(fenOption) ? parser.value(fenOption)
+                                                : BasicPosition<8>::startPosition().toFen();
+    quint64 nodes = 0;
+    if (!runPerft(fen, args[0].toInt(), parser.isSet(divideOption), nodes)) {
+        out() << "invalid position: " << fen << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "position.h"
+#include <QStringList>
+
+template <int N>
+BasicPosition<N> BasicPosition<N>::startPosition()
+{
+    // 8x8 与 10x10 的标准布局均为距边 N/3 格的对称排布
+    constexpr int offset = N / 3;
+    BasicPosition position;
+    position.black = Geometry::squareBit(Geometry::squareOf(0, offset))
+                     | Geometry::squareBit(Geometry::squareOf(0, N - 1 - offset))
+                     | Geometry::squareBit(Geometry::squareOf(offset, 0))
+                     | Geometry::squareBit(Geometry::squareOf(offset, N - 1));
+    position.white = Geometry::squareBit(Geometry::squareOf(N - 1, offset))
+                     | Geometry::squareBit(Geometry::squareOf(N - 1, N - 1 - offset))
+                     | Geometry::squareBit(Geometry::squareOf(N - 1 - offset, 0))
+                     | Geometry::squareBit(Geometry::squareOf(N - 1 - offset, N - 1));
+    position.key = position.computeKey();
+    return position;
+}
+
+template <int N>
+QString BasicPosition<N>::toFen() const
+{
+    QString fen;
+    for (int row = 0; row < N; row++) {
+        if (row > 0) fen += '/';
+        int emptyCount = 0;
+        for (int col = 0; col < N; col++) {
+            const Bitboard bit = Geometry::squareBit(Geometry::squareOf(row, col));
+            char symbol = 0;
+            if (white & bit) symbol = 'W';
+            else if (black & bit) symbol = 'B';
+            else if (arrows & bit) symbol = 'x';
+
+            if (symbol == 0) {
+                emptyCount++;
+                continue;
+            }
+            if (emptyCount > 0) fen += QString::number(emptyCount);
+            emptyCount = 0;
+            fen += QChar(symbol);
+        }
+        if (emptyCount > 0) fen += QString::number(emptyCount);
+    }
+    fen += whiteToMove ? " w" : " b";
+    return fen;
+}
+
+template <int N>
+bool BasicPosition<N>::fromFen(const QString &fen, BasicPosition &position)
+{
+    const QStringList fields = fen.trimmed().split(' ', Qt::SkipEmptyParts);
+    if (fields.size() != 2 || (fields[1] != "w" && fields[1] != "b")) return false;
+
+    const QStringList rows = fields[0].split('/');
+    if (rows.size() != N) return false;
+
+    BasicPosition result;
+    for (int row = 0; row < N; row++) {
+        int col = 0;
+        int emptyCount = 0;
+        for (const QChar c : rows[row]) {
+            if (c.isDigit()) {
+                emptyCount = emptyCount * 10 + c.digitValue();
+                continue;
+            }
+            col += emptyCount;
+            emptyCount = 0;
+            if (col >= N) return false;
+
+            const Bitboard bit = Geometry::squareBit(Geometry::squareOf(row, col));
+            if (c == 'W') result.white |= bit;
+            else if (c == 'B') result.black |= bit;
+            else if (c == 'x') result.arrows |= bit;
+            else return false;
+            col++;
+        }
+        if (col + emptyCount != N) return false;
+    }
+
+    result.whiteToMove = fields[1] == "w";
+    result.key = result.computeKey();
+    position = result;
+    return true;
+}
+
+int fenBoardSize(const QString &fen)
+{
+    return fen.trimmed().section(' ', 0, 0).count('/') + 1;
+}
+
+template <int N>
+quint64 BasicPosition<N>::computeKey() const
+{
+    quint64 result = whiteToMove ? 0 : Zobrist.blackToMove;
+    for (Bitboard b = white; b; ) result ^= Zobrist.white[popLsb(b)];
+    for (Bitboard b = black; b; ) result ^= Zobrist.black[popLsb(b)];
+    for (Bitboard b = arrows; b; ) result ^= Zobrist.arrows[popLsb(b)];
+    return result;
+}
+
+template <int N>
+MoveRange BasicPosition<N>::getMoveRange(int square) const
+{
+    MoveRange range = getReachRange(square);
+    range.territoryArea = getTerritoryArea(square, static_cast<bool>(white & Geometry::squareBit(square)));
+    return range;
+}
+
+template <int N>
+MoveRange BasicPosition<N>::getReachRange(int square) const
+{
+    MoveRange range;
+    const Bitboard reach = queenReach<N>(square, empty());
+
+    // 各方向步数即可达范围与该方向射线的交集大小
+    range.up        = popCount(reach & RayMasks<N>[Up][square]);
+    range.upRight   = popCount(reach & RayMasks<N>[UpRight][square]);
+    range.right     = popCount(reach & RayMasks<N>[Right][square]);
+    range.downRight = popCount(reach & RayMasks<N>[DownRight][square]);
+    range.down      = popCount(reach & RayMasks<N>[Down][square]);
+    range.downLeft  = popCount(reach & RayMasks<N>[DownLeft][square]);
+    range.left      = popCount(reach & RayMasks<N>[Left][square]);
+    range.upLeft    = popCount(reach & RayMasks<N>[UpLeft][square]);
+
+    return range;
+}
+
+template <int N>
+int BasicPosition<N>::getTerritoryArea(int square, bool isWhite) const
+{
+    return getTerritory(square).areaFor(isWhite);
+}
+
+template <int N>
+typename BasicPosition<N>::Territory BasicPosition<N>::getTerritory(int square) const
+{
+    Territory territory;
+    // 障碍物以外的格子均可通行, 区域内出现敌方棋子即说明不在官子区域
+    territory.region = floodFill<N>(Geometry::squareBit(square), ~arrows & BoardMask<N>);
+    territory.area = popCount(territory.region & empty());
+    territory.hasWhite = static_cast<bool>(territory.region & white);
+    territory.hasBlack = static_cast<bool>(territory.region & black);
+    return territory;
+}
+
+template struct BasicPosition<8>;
+template struct BasicPosition<10>;
@@ -0,0 +1,213 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <QPair>
+#include <QString>
+#include "bitboard.h"
+#include "zobrist.h"
+
+// 棋盘上某位置棋子可移动范围的数据结构
+struct MoveRange {
+    int up = 0;
+    int down = 0;
+    int left = 0;
+    int right = 0;
+    int upLeft = 0;
+    int upRight = 0;
+    int downLeft = 0;
+    int downRight = 0;
+    int territoryArea = -1; // -1代表未处于官子阶段，否则为官子阶段领地大小
+
+    // 获取走法总数
+    int getTotalMoves() const {
+        return up + down + left + right
+               + upLeft + upRight + downLeft + downRight;
+    }
+
+    bool canMove() const {
+        return getTotalMoves() > 0;
+    }
+
+    bool inClosedRegion() const {
+        return territoryArea >= 0;
+    }
+};
+
+// 一步行棋的数据结构
+struct Move
+{
+    // 原始位置
+    QPair<int, int> startPos = {-1, -1};
+    // 目标位置
+    QPair<int, int> targetPos = {-1, -1};
+    // 射箭位置
+    QPair<int, int> shootPos = {-1, -1};
+
+    // 显式声明默认构造函数和拷贝赋值，让 Clazy 闭嘴
+    Move() = default;
+    Move(const Move&) = default;
+    Move& operator=(const Move&) = default;
+};
+
+// 紧凑的走法编码: 起点、终点、射箭点的格子编号依次存放于一个 quint32
+// 每个编号占 SquareBits 位(8x8 为6位, 10x10 为7位)
+// 用于走法列表与搜索内部, 与界面、存档交互时再转换为 Move
+template <int N>
+struct BasicPackedMove
+{
+    using Geometry = BoardGeometry<N>;
+    static constexpr int SquareBits = Geometry::Squares <= 64 ? 6 : 7;
+    static constexpr quint32 SquareMask = (1u << SquareBits) - 1;
+
+    quint32 bits = 0; // 0 代表空走法(起点与终点不可能相同)
+
+    constexpr BasicPackedMove() = default;
+    constexpr BasicPackedMove(int from, int to, int arrow)
+        : bits(static_cast<quint32>(from | (to << SquareBits) | (arrow << (2 * SquareBits)))) {}
+
+    constexpr int from() const { return bits & SquareMask; }
+    constexpr int to() const { return (bits >> SquareBits) & SquareMask; }
+    constexpr int arrow() const { return (bits >> (2 * SquareBits)) & SquareMask; }
+    constexpr bool isNull() const { return bits == 0; }
+
+    constexpr bool operator==(BasicPackedMove other) const { return bits == other.bits; }
+    constexpr bool operator!=(BasicPackedMove other) const { return bits != other.bits; }
+
+    // 与 Move 的互相转换
+    // 棋谱记法, 如 "d1-d7/g7": 列用字母, 行自下而上从1开始编号, 斜杠后为射箭点
+    QString toString() const {
+        auto square = [](int sq) {
+            return QString(QChar('a' + Geometry::colOf(sq))) + QString::number(N - Geometry::rowOf(sq));
+        };
+        return square(from()) + '-' + square(to()) + '/' + square(arrow());
+    }
+
+    static BasicPackedMove fromMove(const Move &move) {
+        return BasicPackedMove(Geometry::squareOf(move.startPos.first, move.startPos.second),
+                               Geometry::squareOf(move.targetPos.first, move.targetPos.second),
+                               Geometry::squareOf(move.shootPos.first, move.shootPos.second));
+    }
+    Move toMove() const {
+        Move move;
+        if (isNull()) return move;
+        move.startPos = {Geometry::rowOf(from()), Geometry::colOf(from())};
+        move.targetPos = {Geometry::rowOf(to()), Geometry::colOf(to())};
+        move.shootPos = {Geometry::rowOf(arrow()), Geometry::colOf(arrow())};
+        return move;
+    }
+};
+
+// 以位棋盘表示的 N x N 局面, 供AI搜索、走法生成与评估使用
+// 与 Chessboard::Board 的互相转换见 Chessboard::boardToPosition / positionToBoard
+template <int N>
+struct BasicPosition
+{
+    using Geometry = BoardGeometry<N>;
+    using Bitboard = BitboardOf<N>;
+    using PackedMove = BasicPackedMove<N>;
+    static_assert(Geometry::Squares <= ZobristKeys::MaxSquares);
+
+    // 以障碍物分隔的一个连通区域的洪水填充结果
+    struct Territory
+    {
+        Bitboard region{};      // 区域内的所有格子(含棋子)
+        int area = 0;           // 区域内的空格数
+        bool hasWhite = false;  // 区域内是否有白方棋子
+        bool hasBlack = false;  // 区域内是否有黑方棋子
+
+        bool hasEnemyOf(bool isWhite) const { return isWhite ? hasBlack : hasWhite; }
+        // 对指定一方而言的领地大小, 区域内有敌方棋子时为-1
+        int areaFor(bool isWhite) const { return hasEnemyOf(isWhite) ? -1 : area; }
+    };
+
+    Bitboard white{};  // 白方棋子
+    Bitboard black{};  // 黑方棋子
+    Bitboard arrows{}; // 障碍(箭)
+    bool whiteToMove = true;
+    // 局面的 Zobrist 哈希值, 走子、射箭与换边时增量更新
+    quint64 key = 0;
+
+    // 标准开局: 双方各四个棋子, 白方先行
+    static BasicPosition startPosition();
+
+    // 局面串: 自上而下逐行列出, 行间以 '/' 分隔, W/B 为白/黑棋子, x 为障碍, 数字为连续空格数,
+    // 最后以空格隔开行棋方 w/b, 如 8x8 开局为 "2B2B2/8/B6B/8/8/W6W/8/2W2W2 w"
+    QString toFen() const;
+    // 解析局面串, 格式或尺寸不符时返回 false
+    static bool fromFen(const QString &fen, BasicPosition &position);
+
+    Bitboard pieces(bool isWhite) const { return isWhite ? white : black; }
+    Bitboard occupied() const { return white | black | arrows; }
+    Bitboard empty() const { return ~occupied() & BoardMask<N>; }
+
+    // 指定一方是否还有棋可走: 某个棋子的王步邻域内有空格即可移动, 且移动后原位置必然可以射箭
+    bool canMove(bool isWhite) const { return static_cast<bool>(dilate<N>(pieces(isWhite)) & empty()); }
+    // 行棋方无棋可走即为终局
+    bool isTerminal() const { return !canMove(whiteToMove); }
+
+    // 根据当前局面完整计算哈希值
+    quint64 computeKey() const;
+
+    // 增量修改局面并同步更新哈希值
+    // 将 from 上的棋子移动到 to
+    void movePiece(int from, int to) {
+        const Bitboard fromTo = Geometry::squareBit(from) | Geometry::squareBit(to);
+        if (white & Geometry::squareBit(from)) {
+            white ^= fromTo;
+            key ^= Zobrist.white[from] ^ Zobrist.white[to];
+        } else {
+            black ^= fromTo;
+            key ^= Zobrist.black[from] ^ Zobrist.black[to];
+        }
+    }
+    void placeArrow(int square) {
+        arrows |= Geometry::squareBit(square);
+        key ^= Zobrist.arrows[square];
+    }
+    void removeArrow(int square) {
+        arrows &= ~Geometry::squareBit(square);
+        key ^= Zobrist.arrows[square];
+    }
+    void setWhiteToMove(bool isWhite) {
+        if (whiteToMove != isWhite) {
+            whiteToMove = isWhite;
+            key ^= Zobrist.blackToMove;
+        }
+    }
+
+    // 执行/撤销一步行棋: 只改动起点、终点与射箭点三个格子并切换行棋方, 不做合法性检查
+    void make(int from, int to, int arrow) {
+        movePiece(from, to);
+        placeArrow(arrow);
+        setWhiteToMove(!whiteToMove);
+    }
+    void unmake(int from, int to, int arrow) {
+        setWhiteToMove(!whiteToMove);
+        removeArrow(arrow);
+        movePiece(to, from);
+    }
+    void make(PackedMove move) { make(move.from(), move.to(), move.arrow()); }
+    void unmake(PackedMove move) { unmake(move.from(), move.to(), move.arrow()); }
+
+    // 获取指定格子上棋子的活动范围
+    MoveRange getMoveRange(int square) const;
+    // 获取指定格子出发的各方向可移动步数, 不计算领地
+    MoveRange getReachRange(int square) const;
+    // 获取处于官子阶段的指定棋子领地大小(非官子阶段为-1)
+    int getTerritoryArea(int square, bool isWhite) const;
+    // 对指定格子所在的连通区域做洪水填充
+    Territory getTerritory(int square) const;
+};
+
+// 局面串描述的棋盘边长(即行数)
+int fenBoardSize(const QString &fen);
+
+// 成员函数定义于 position.cpp, 在其中显式实例化以下尺寸
+extern template struct BasicPosition<8>;
+extern template struct BasicPosition<10>;
+
+// 界面使用的标准 8x8 棋盘
+using Position = BasicPosition<8>;
+using PackedMove = BasicPackedMove<8>;
+
+#endif // POSITION_H
@@ -0,0 +1,101 @@
+#include "regiontracker.h"
+
+template <int N>
+void BasicRegionTracker<N>::reset(const Position &position)
+{
+    m_label.fill(NoRegion);
+    m_regionCount = 0;
+    m_mixedRegions = 0;
+    m_undoSize = 0;
+
+    // 逐个填充障碍以外的连通区域
+    Bitboard remaining = ~position.arrows & BoardMask<N>;
+    while (remaining) {
+        const Bitboard cells = floodFill<N>(lowestBit(remaining), remaining);
+        addRegion(position, cells);
+        remaining &= ~cells;
+    }
+}
+
+template <int N>
+void BasicRegionTracker<N>::placeArrow(const Position &position, int square)
+{
+    const int index = m_label[square];
+    Region &region = m_regions[index];
+
+    // 记录撤销信息
+    UndoEntry &entry = m_undoStack[m_undoSize++];
+    entry.region = region;
+    entry.square = static_cast<quint8>(square);
+    entry.regionIndex = static_cast<quint8>(index);
+    entry.regionCount = static_cast<quint8>(m_regionCount);
+    entry.mixedRegions = static_cast<quint8>(m_mixedRegions);
+
+    m_label[square] = NoRegion;
+    const Bitboard remaining = region.cells & ~Geometry::squareBit(square);
+    region.cells = remaining;
+
+    // 障碍周围仍属于该区域的格子, 只有它们之间可能失去连通
+    const Bitboard neighbours = dilate<N>(Geometry::squareBit(square)) & remaining;
+    if (popCount(neighbours) <= 1
+        || floodFill<N>(lowestBit(neighbours), neighbours) == neighbours) {
+        // 邻格在局部已互相连通, 区域不会分裂
+        return;
+    }
+
+    const Bitboard first = floodFill<N>(lowestBit(neighbours), remaining);
+    if (!(neighbours & ~first)) {
+        return; // 绕行后仍然连通
+    }
+
+    // 区域分裂: 原编号保留第一块, 其余每块登记为新区域
+    if (region.isMixed()) m_mixedRegions--;
+    region.cells = first;
+    region.whiteCount = static_cast<quint8>(popCount(first & position.white));
+    region.blackCount = static_cast<quint8>(popCount(first & position.black));
+    if (region.isMixed()) m_mixedRegions++;
+
+    Bitboard rest = remaining & ~first;
+    while (rest) {
+        const Bitboard seed = neighbours & rest;
+        const Bitboard cells = floodFill<N>(lowestBit(seed), rest);
+        addRegion(position, cells);
+        rest &= ~cells;
+    }
+}
+
+template <int N>
+void BasicRegionTracker<N>::undo()
+{
+    const UndoEntry &entry = m_undoStack[--m_undoSize];
+
+    // 将分裂出的区域并回原区域
+    for (int i = entry.regionCount; i < m_regionCount; i++) {
+        for (Bitboard b = m_regions[i].cells; b; ) {
+            m_label[popLsb(b)] = entry.regionIndex;
+        }
+    }
+    m_regionCount = entry.regionCount;
+    m_mixedRegions = entry.mixedRegions;
+
+    m_regions[entry.regionIndex] = entry.region;
+    m_label[entry.square] = entry.regionIndex;
+}
+
+template <int N>
+void BasicRegionTracker<N>::addRegion(const Position &position, Bitboard cells)
+{
+    Region &region = m_regions[m_regionCount];
+    region.cells = cells;
+    region.whiteCount = static_cast<quint8>(popCount(cells & position.white));
+    region.blackCount = static_cast<quint8>(popCount(cells & position.black));
+    if (region.isMixed()) m_mixedRegions++;
+
+    for (Bitboard b = cells; b; ) {
+        m_label[popLsb(b)] = static_cast<quint8>(m_regionCount);
+    }
+    m_regionCount++;
+}
+
+template class BasicRegionTracker<8>;
+template class BasicRegionTracker<10>;
@@ -0,0 +1,85 @@
+#ifndef REGIONTRACKER_H
+#define REGIONTRACKER_H
+
+#include "position.h"
+
+// 连通区域划分的增量维护
+// 棋盘被障碍物分隔为若干八连通区域, 棋子移动不会改变划分, 只有射箭可能把一个区域一分为多.
+// 因此放置障碍时只在局部检查是否发生分裂, 撤销时按栈顺序还原, 查询均为O(1)
+template <int N>
+class BasicRegionTracker
+{
+public:
+    using Geometry = BoardGeometry<N>;
+    using Bitboard = BitboardOf<N>;
+    using Position = BasicPosition<N>;
+
+    static constexpr int MaxRegions = Geometry::Squares;
+    static constexpr quint8 NoRegion = 0xff;
+
+    // 根据局面重新计算完整的区域划分
+    void reset(const Position &position);
+    // 在 square 处放置障碍后更新划分, position 为放置后的局面
+    void placeArrow(const Position &position, int square);
+    // 撤销最近一次放置障碍
+    void undo();
+
+    // 查询
+    int regionOf(int square) const { return m_label[square]; }
+    Bitboard regionCells(int region) const { return m_regions[region].cells; }
+    // 区域内的空格数
+    int regionArea(int region) const {
+        const Region &r = m_regions[region];
+        return popCount(r.cells) - r.whiteCount - r.blackCount;
+    }
+    bool hasEnemyOf(int region, bool isWhite) const {
+        return (isWhite ? m_regions[region].blackCount : m_regions[region].whiteCount) > 0;
+    }
+    // 指定格子上的棋子是否被封闭在不含敌方棋子的区域内
+    bool isEnclosed(int square, bool isWhite) const { return !hasEnemyOf(m_label[square], isWhite); }
+    // 对指定一方而言该格所在区域的领地大小, 区域内有敌方棋子时为-1
+    int getTerritoryArea(int square, bool isWhite) const {
+        return isEnclosed(square, isWhite) ? regionArea(m_label[square]) : -1;
+    }
+    // 是否已分割为互不相干的区域(没有任何区域同时含有双方棋子)
+    bool isPartitioned() const { return m_mixedRegions == 0; }
+
+private:
+    struct Region
+    {
+        Bitboard cells{};   // 区域内的格子(含棋子, 不含障碍)
+        quint8 whiteCount = 0;
+        quint8 blackCount = 0;
+
+        bool isMixed() const { return whiteCount > 0 && blackCount > 0; }
+    };
+
+    // 一次放置障碍的撤销记录
+    struct UndoEntry
+    {
+        Region region;       // 被放置障碍的区域原状态
+        quint8 square;       // 障碍位置
+        quint8 regionIndex;  // 被放置障碍的区域编号
+        quint8 regionCount;  // 放置前的区域总数
+        quint8 mixedRegions; // 放置前同时含双方棋子的区域数
+    };
+
+    // 将一块格子登记为新区域
+    void addRegion(const Position &position, Bitboard cells);
+
+    std::array<quint8, Geometry::Squares> m_label{}; // 每个格子所属的区域编号
+    std::array<Region, MaxRegions> m_regions{};
+    int m_regionCount = 0;
+    int m_mixedRegions = 0;
+
+    std::array<UndoEntry, Geometry::Squares> m_undoStack{};
+    int m_undoSize = 0;
+};
+
+// 成员函数定义于 regiontracker.cpp, 在其中显式实例化以下尺寸
+extern template class BasicRegionTracker<8>;
+extern template class BasicRegionTracker<10>;
+
+using RegionTracker = BasicRegionTracker<8>;
+
+#endif // REGIONTRACKER_H
@@ -32,16 +32,16 @@ Chessboard::Board SaveGame::jsonArrayToBoard(const QJsonArray &boardArray)
 {
     Chessboard::Board board;
 
-    if (boardArray.size() != 8) {
+    if (boardArray.size() != Chessboard::BoardSize) {
         return board; // 返回空棋盘
     }
 
-    for (int r = 0; r < 8; r++) {
+    for (int r = 0; r < Chessboard::BoardSize; r++) {
         QJsonArray rowArray = boardArray[r].toArray();
-        if (rowArray.size() != 8) {
+        if (rowArray.size() != Chessboard::BoardSize) {
             return board; // 返回空棋盘
         }
-        for (int c = 0; c < 8; c++) {
+        for (int c = 0; c < Chessboard::BoardSize; c++) {
             board[r][c] = static_cast<Chessboard::Cell>(rowArray[c].toInt());
         }
     }
@@ -168,7 +168,7 @@ bool SaveGame::loadSave(QString filePath)
     }
 
     QJsonArray boardArray = saveObj["board"].toArray();
-    if (boardArray.size() != 8) {
+    if (boardArray.size() != Chessboard::BoardSize) {
         return false;
     }
 
@@ -191,7 +191,7 @@ bool SaveGame::loadSave(QString filePath)
         if (selectedArray.size() == 2) {
             int row = selectedArray[0].toInt();
             int col = selectedArray[1].toInt();
-            if (row >= 0 && row < 8 && col >= 0 && col < 8) {
+            if (row >= 0 && row < Chessboard::BoardSize && col >= 0 && col < Chessboard::BoardSize) {
                 m_chessboard->m_selected = QPair<int, int>(row, col);
             }
         }
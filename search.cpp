@@ -0,0 +1,1310 @@
+#include "search.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+template <int N>
+Search<N>::Search(bool isWhite, EvalWeights weights)
+    : m_isWhite{isWhite}
+    , m_stack{std::make_unique<SearchStack<N>>()}
+    , m_history{std::make_unique<HistoryTable<N>>()}
+    , m_counterMoves{std::make_unique<CounterMoveTable<N>>()}
+    , m_tt{std::make_shared<TranspositionTable<N>>()}
+    , m_main{this}
+    , m_endgame{false}
+    , m_weights{weights}
+{
+    resetSandbox(); // 初始化沙盒局面
+}
+
+template <int N>
+Search<N>::Search(Search &main, int)
+    : m_isWhite{main.m_isWhite}
+    , m_stack{std::make_unique<SearchStack<N>>()}
+    , m_history{std::make_unique<HistoryTable<N>>()}
+    , m_counterMoves{std::make_unique<CounterMoveTable<N>>()}
+    , m_tt{main.m_tt}
+    , m_main{&main}
+    , m_splitPoints{std::make_unique<SplitPoint<N>[]>(SearchStack<N>::MaxPly)}
+    , m_endgame{false}
+    , m_weights{main.m_weights}
+{
+    resetSandbox();
+}
+
+template <int N>
+void Search<N>::setThreadCount(int count)
+{
+    m_helpers.clear();
+    for (int i = 1; i < count; i++) {
+        m_helpers.push_back(std::unique_ptr<Search>(new Search(*this, i)));
+    }
+    if (!m_helpers.empty() && !m_splitPoints) {
+        m_splitPoints = std::make_unique<SplitPoint<N>[]>(SearchStack<N>::MaxPly);
+    }
+}
+
+template <int N>
+void Search<N>::setHalfPlySearch(bool enabled)
+{
+    if (enabled == m_halfPly) return;
+    m_halfPly = enabled;
+    m_tt->clear();
+}
+
+template <int N>
+void Search<N>::setRootPosition(const Position &position)
+{
+    m_root = position;
+    resetSandbox();
+}
+
+template <int N>
+void Search<N>::reset()
+{
+    m_endgame = false;
+    m_endgameMoves.clear();
+    m_endgameVisited.clear();
+    resetSandbox();
+}
+
+template <int N>
+typename Search<N>::PackedMove Search<N>::nextMove(const SearchLimits &limits)
+{
+    if (!m_endgame && isEndgame(m_sandbox, m_regions, m_isWhite)) {
+        m_endgame = true;
+    }
+
+    // 官子阶段按预先求得的走法序列行棋
+    if (m_endgame) {
+        if (m_endgameMoves.size() == 0) {
+            m_endgameMoves = getEndgameMoves();
+        }
+        if (m_endgameMoves.size() > 0) {
+            return m_endgameMoves.takeFirst(); // 提取并移除首个元素
+        }
+        return PackedMove();
+    }
+
+    return iterativeDeepening(limits);
+}
+
+template <int N>
+typename Search<N>::PackedMove Search<N>::nextMove(int depth)
+{
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    return nextMove(limits);
+}
+
+template <int N>
+typename Search<N>::AllMoves Search<N>::getAllMovesForSide(bool isWhite) const
+{
+    return getAllMovesForSide(m_sandbox, isWhite, m_regions);
+}
+
+template <int N>
+typename Search<N>::AllMoves Search<N>::getAllMovesForSide(const Position &position, bool isWhite, const RegionTracker &regions) const
+{
+    AllMoves allMoves;
+    int index = 0; // 棋子索引
+
+    const Bitboard emptySquares = position.empty();
+
+    // 获取所有棋子位置与可行动范围
+    Bitboard pieces = position.pieces(isWhite);
+    while (pieces) {
+        int square = popLsb(pieces);
+        allMoves.positions[index] = {Geometry::rowOf(square), Geometry::colOf(square)};
+        allMoves.moves[index] = position.getReachRange(square);
+        allMoves.moves[index].territoryArea = regions.getTerritoryArea(square, isWhite);
+
+        // 非官子阶段下跳过处于官子状态的棋子
+        if (!m_endgame && allMoves.moves[index].inClosedRegion()) {
+            index++;
+            continue;
+        }
+
+        allMoves.moveOpts += allMoves.moves[index].getTotalMoves();
+
+        // 获取当前每种移动方式对应的射箭方式总数
+        // 模拟移动后原位置视为空
+        const Bitboard shootEmpty = emptySquares | Geometry::squareBit(square);
+        allMoves.actionCount += countSlides<N>(queenReach<N>(square, emptySquares), shootEmpty);
+        index++;
+    }
+
+    return allMoves;
+}
+
+template <int N>
+bool Search<N>::isEndgame(const Position &position, const RegionTracker &regions, bool isWhite)
+{
+    const Bitboard emptySquares = position.empty();
+    Bitboard pieces = position.pieces(isWhite);
+    while (pieces) {
+        int square = popLsb(pieces);
+        // 棋子仍与敌方相连且可以移动
+        if (!regions.isEnclosed(square, isWhite) && (dilate<N>(Geometry::squareBit(square)) & emptySquares)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+QVector<typename Search<N>::PackedMove> Search<N>::getEndgameMoves(int pieceSquare)
+{
+    // 初始化：寻找第一个可移动的棋子
+    if (pieceSquare == -1) {
+        m_endgameMoves.clear();
+        m_endgameVisited.clear();
+        resetSandbox();
+        AllMoves allMoves = getAllMovesForSide(m_isWhite);
+
+        // 获取第一个可行动的棋子位置
+        int index = 0;
+        for (; index < 4; index++) {
+            if (allMoves.moves[index].getTotalMoves() > 0) {
+                pieceSquare = Geometry::squareOf(allMoves.positions[index].first, allMoves.positions[index].second);
+                break;
+            }
+        }
+
+        // 空格过多时直接返回第一种走法
+        MoveRange curMoveRange = allMoves.moves[index];
+        if (curMoveRange.territoryArea > 12) {
+            // 只生成该棋子的走法并返回第一个
+            MoveGenerator<N> generator(m_sandbox, Geometry::squareBit(pieceSquare));
+            PackedMove move;
+            if (generator.next(move)) {
+                return {move};
+            }
+            return {};
+        }
+        return getEndgameMoves(pieceSquare);
+    }
+
+    // 防止重复访问相同局面
+    if (m_endgameVisited.contains(m_sandbox.key)) {
+        return {};
+    }
+    m_endgameVisited.insert(m_sandbox.key);
+
+    // 获取当前棋子的领地大小
+    int territoryArea = m_regions.getTerritoryArea(pieceSquare, m_isWhite);
+
+    QVector<PackedMove> bestMoves;
+
+    // 只生成指定棋子的走法, 逐个进行回溯搜索
+    MoveGenerator<N> generator(m_sandbox, Geometry::squareBit(pieceSquare));
+    PackedMove move;
+    while (generator.next(move)) {
+        makeMoveInSandbox(move);
+
+        // 递归搜索后续走法序列
+        QVector<PackedMove> followingMoves = getEndgameMoves(move.to());
+
+        // 选择最长的走法序列
+        if (followingMoves.size() + 1 > bestMoves.size()) {
+            bestMoves = followingMoves;
+            bestMoves.push_front(move);
+        }
+
+        // 撤销走法
+        unmakeMoveInSandbox(move);
+
+        // 提前终止条件：已达到最大可能步数
+        if (territoryArea == bestMoves.size()) {
+            break;
+        }
+    }
+
+    return bestMoves;
+}
+
+template <int N>
+void Search<N>::makeMoveInSandbox(PackedMove move)
+{
+    m_sandbox.make(move);
+    m_regions.placeArrow(m_sandbox, move.arrow());
+}
+
+template <int N>
+void Search<N>::unmakeMoveInSandbox(PackedMove move)
+{
+    m_regions.undo();
+    m_sandbox.unmake(move);
+}
+
+template <int N>
+void Search<N>::resetSandbox()
+{
+    m_sandbox = m_root;
+    m_regions.reset(m_sandbox);
+}
+
+template <int N>
+double Search<N>::evaluate(const Position &position)
+{
+    m_sandbox = position;
+    m_regions.reset(m_sandbox);
+    return evalSandbox();
+}
+
+template <int N>
+typename Search<N>::Mobility Search<N>::countMobility(bool isWhite) const
+{
+    Mobility mobility;
+    int index = 0; // 棋子索引
+
+    const Bitboard emptySquares = m_sandbox.empty();
+
+    Bitboard pieces = m_sandbox.pieces(isWhite);
+    while (pieces) {
+        const int square = popLsb(pieces);
+        mobility.squares[index++] = square;
+
+        const Bitboard reach = queenReach<N>(square, emptySquares);
+        const int territoryArea = m_regions.getTerritoryArea(square, isWhite);
+        if (territoryArea >= 0) {
+            mobility.territory += territoryArea;
+        } else if (reach) {
+            mobility.endgame = false;
+        }
+
+        // 非官子阶段下跳过处于官子状态的棋子
+        if (!m_endgame && territoryArea >= 0) continue;
+
+        // 所有落点的射箭方式一次性计数, 移动后原位置视为空
+        mobility.moveOpts += popCount(reach);
+        mobility.actionCount += countSlides<N>(reach, emptySquares | Geometry::squareBit(square));
+    }
+
+    return mobility;
+}
+
+template <int N>
+double Search<N>::evalSandbox()
+{
+    // 获取双方的机动性统计
+    const Mobility myMoves = countMobility(m_isWhite);
+    const Mobility oppMoves = countMobility(!m_isWhite);
+
+    double score = 0.0;
+
+    // 1. 移动性评分
+    int myTotalMoves = myMoves.moveOpts;
+    int oppTotalMoves = oppMoves.moveOpts;
+
+    // 幂函数调整
+    double mobilityDiffVal = std::pow(std::abs((double)(myTotalMoves - oppTotalMoves)), m_weights.mobilityExponent);
+    mobilityDiffVal *= (myTotalMoves - oppTotalMoves >= 0 ? 1 : -1);
+    double mobilityScore = mobilityDiffVal * m_weights.mobilityWeight;
+    // 标准化
+    mobilityScore /= 4.0 * MaxQueenMoves;
+    score += mobilityScore;
+
+    // 2. 射箭灵活性评分
+    int myShootOpts = myMoves.actionCount;
+    int oppShootOpts = oppMoves.actionCount;
+
+    // 幂函数调整
+    double shootDiffVal = std::pow(std::abs((double)(myShootOpts - oppShootOpts)), m_weights.shootExponent);
+    shootDiffVal *= (myShootOpts - oppShootOpts >= 0 ? 1 : -1);
+    double shootScore = shootDiffVal * m_weights.shootFlexibilityWeight;
+    // 标准化
+    shootScore /= 4.0 * MaxQueenMoves * MaxQueenMoves;
+    score += shootScore;
+
+    // 3. 官子阶段特殊处理
+    if (myMoves.endgame || oppMoves.endgame) {
+        // 领地大小
+        double territoryScore = (myMoves.territory - oppMoves.territory) * m_weights.territoryWeight;
+        // 标准化
+        territoryScore /= TerritoryScale;
+        score += territoryScore;
+    } else {
+        // 4. 非官子阶段：中心控制评分
+        double centerScore = 0.0;
+        for (int i = 0; i < 4; i++) {
+            // 计算到棋盘中心的曼哈顿距离
+            double myDistToCenter = std::abs(Geometry::rowOf(myMoves.squares[i]) - CenterCoord)
+                                    + std::abs(Geometry::colOf(myMoves.squares[i]) - CenterCoord);
+            double oppDistToCenter = std::abs(Geometry::rowOf(oppMoves.squares[i]) - CenterCoord)
+                                     + std::abs(Geometry::colOf(oppMoves.squares[i]) - CenterCoord);
+
+            // 距离中心越近越好
+            centerScore += (oppDistToCenter - myDistToCenter);
+        }
+        // 标准化
+        centerScore /= CenterScale;
+        score += centerScore * m_weights.centerControlWeight;
+
+        // 5. 分散性评分
+        double myDistance = 0.0;
+        double oppDistance = 0.0;
+
+        for (int i = 0; i < 4; i++) {
+            for (int j = i + 1; j < 4; j++) {
+                // 使用曼哈顿距离
+                int myDist = std::abs(Geometry::rowOf(myMoves.squares[i]) - Geometry::rowOf(myMoves.squares[j]))
+                             + std::abs(Geometry::colOf(myMoves.squares[i]) - Geometry::colOf(myMoves.squares[j]));
+                int oppDist = std::abs(Geometry::rowOf(oppMoves.squares[i]) - Geometry::rowOf(oppMoves.squares[j]))
+                              + std::abs(Geometry::colOf(oppMoves.squares[i]) - Geometry::colOf(oppMoves.squares[j]));
+
+                myDistance += myDist;
+                oppDistance += oppDist;
+            }
+        }
+
+        // 距离越大越好
+        double dispersionScore = (myDistance - oppDistance) * m_weights.dispersionWeight;
+        // 标准化
+        dispersionScore /= DispersionScale;
+        score += dispersionScore;
+    }
+
+    // 特殊判断：如果对手无法移动，给予巨大奖励
+    if (oppTotalMoves == 0) {
+        score += 1e9;
+    }
+    // 如果自己无法移动，给予巨大惩罚
+    if (myTotalMoves == 0) {
+        score -= 1e9;
+    }
+
+    return score;
+}
+
+template <int N>
+typename Search<N>::PackedMove Search<N>::iterativeDeepening(const SearchLimits &limits)
+{
+    m_tt->newSearch();
+    m_timer.start();
+    m_timeBudget = limits.timeMs;
+    m_cancel = limits.cancel;
+    m_ponder = limits.ponder;
+    m_stopFlag = false;
+    resetThreadState();
+    m_pv.clear();
+
+    // 半步搜索的根节点枚举完整走法, 至少搜索两层
+    const int maxDepth = qMax(qMin(limits.maxDepth, SearchStack<N>::MaxPly - 1), moveDepth());
+
+    // Lazy SMP: 辅助线程从同一根局面开始各自迭代加深, 只通过置换表影响主线程
+    // YBW: 辅助线程等待主线程(及其他辅助线程)在搜索中公开的分裂点
+    std::vector<std::thread> threads;
+    m_idleHelpers = 0;
+    for (int i = 0; i < static_cast<int>(m_helpers.size()); i++) {
+        Search *helper = m_helpers[i].get();
+        if (m_parallelMode == ParallelMode::YoungBrothersWait) {
+            threads.emplace_back([helper]() { helper->helperWaitForWork(); });
+        } else {
+            helper->m_root = m_root;
+            helper->resetSandbox();
+            threads.emplace_back([helper, i, maxDepth]() { helper->helperSearch(i + 1, maxDepth); });
+        }
+    }
+
+    PackedMove bestMove;
+    qint64 previousNodes = 0;
+    for (int depth = moveDepth(); depth <= maxDepth; depth++) {
+        const qint64 iterationStart = m_timer.nsecsElapsed();
+        const quint64 nodesBefore = m_nodes;
+
+        // 以上一次迭代的评分为中心设置期望窗口, 评分落在窗口外时向失败的一侧逐步放宽后重新搜索
+        double score = 0.0;
+        double window = AspirationWindow;
+        // 第一次迭代(半步搜索中为深度2)还没有可作中心的评分
+        const bool aspirate = depth > moveDepth() && std::abs(m_info.score) < 1e9;
+        double alpha = aspirate ? m_info.score - window : -1e11;
+        double beta = aspirate ? m_info.score + window : 1e11;
+        PackedMove move;
+        while (true) {
+            move = getBestMove(depth, alpha, beta, score);
+            if (stopped() || move.isNull()) break;
+            if (score <= alpha && alpha > -1e11) {
+                window *= 4;
+                alpha = window > MaxAspirationWindow ? -1e11 : m_info.score - window;
+            } else if (score >= beta && beta < 1e11) {
+                window *= 4;
+                beta = window > MaxAspirationWindow ? 1e11 : m_info.score + window;
+            } else {
+                break;
+            }
+        }
+
+        // 被中止的迭代只搜索了部分根节点走法, 结果不可信
+        // 只有第一次迭代也没能完成时, 才退而使用其中已搜索部分的最佳走法
+        if (stopped()) {
+            if (bestMove.isNull()) bestMove = move;
+            break;
+        }
+
+        bestMove = move;
+        m_info.depth = depth;
+        m_info.score = score;
+        const typename SearchStack<N>::Ply &root = m_stack->ply(0);
+        m_pv.clear();
+        for (int i = 0; i < root.pvLength; i++) m_pv.append(root.pv[i]);
+
+        // 无棋可走或已分出胜负时, 更深的搜索不会改变结果
+        if (move.isNull() || std::abs(score) >= 1e10) break;
+
+        // 按本次迭代的节点数增长估计下一次迭代的耗时, 预计无法完成时不再开始
+        const qint64 iterationNodes = static_cast<qint64>(m_nodes - nodesBefore);
+        if (m_timeBudget > 0 && !pondering() && previousNodes > 0) {
+            const double growth = static_cast<double>(iterationNodes) / previousNodes;
+            const double iterationMs = (m_timer.nsecsElapsed() - iterationStart) / 1e6;
+            if (m_timer.elapsed() + iterationMs * growth > m_timeBudget) break;
+        }
+        previousNodes = iterationNodes;
+    }
+
+    // 主线程结束即通知辅助线程中止, 汇总各线程的统计
+    m_stopFlag = true;
+    for (std::thread &thread : threads) thread.join();
+    quint64 nodes = m_nodes;
+    for (const auto &helper : m_helpers) {
+        nodes += helper->m_nodes;
+        m_hashStats += helper->m_hashStats;
+        m_info.cutoffs += helper->m_info.cutoffs;
+        m_info.firstMoveCutoffs += helper->m_info.firstMoveCutoffs;
+    }
+
+    m_info.nodes = nodes;
+    m_info.timeMs = m_timer.elapsed();
+    return bestMove;
+}
+
+template <int N>
+void Search<N>::resetThreadState()
+{
+    m_nodes = 0;
+    m_hashStats = typename TranspositionTable<N>::Stats();
+    m_info = SearchInfo();
+    m_stack->clearKillers();
+    m_history->age();
+    m_stack->ply(0).moves.clear(); // 根节点走法在第一次迭代时重新生成
+}
+
+template <int N>
+void Search<N>::helperSearch(int index, int maxDepth)
+{
+    resetThreadState();
+
+    // 奇数编号的辅助线程领先主线程一层, 使各线程错开, 更多地先填充置换表中主线程随后需要的局面
+    for (int depth = moveDepth() + index % 2; depth <= maxDepth && !stopped(); depth++) {
+        double score = 0.0;
+        getBestMove(depth, -1e11, 1e11, score);
+    }
+}
+
+template <int N>
+void Search<N>::checkTime()
+{
+    // 每 1024 个节点读取一次时钟与取消令牌
+    if ((m_nodes & 1023) == 0 && limitReached()) {
+        m_stopFlag = true;
+    }
+}
+
+template <int N>
+typename Search<N>::PackedMove Search<N>::getBestMove(int depth, double alpha, double beta, double &score)
+{
+    typename SearchStack<N>::Ply &root = m_stack->ply(0);
+    root.pvLength = 0;
+
+    // 根节点走法在本次搜索中只生成一次; 每次迭代把上一次迭代的最佳走法放在最前, 其余按当前的历史得分排序
+    MoveList<N> &moves = root.moves;
+    std::array<int, MoveList<N>::Capacity> &scores = root.scores;
+    if (moves.isEmpty()) {
+        generateLegalMoves(m_isWhite, moves);
+        if (moves.isEmpty()) return PackedMove();
+        scores.fill(0);
+    }
+    for (int i = 0; i < moves.size(); i++) {
+        if (scores[i] != std::numeric_limits<int>::max()) scores[i] = m_history->score(m_isWhite, moves[i]);
+    }
+    sortRootMoves(moves, scores);
+
+    // 置换表中的最佳走法最先尝试, 其余走法保持顺序
+    typename TranspositionTable<N>::Entry entry;
+    if (m_tt->probe(m_sandbox.key, entry, m_hashStats) && !entry.move.isNull()) {
+        PackedMove *found = std::find(moves.begin(), moves.end(), entry.move);
+        if (found != moves.end()) {
+            const int index = static_cast<int>(found - moves.begin());
+            std::rotate(moves.begin(), found, found + 1);
+            std::rotate(scores.begin(), scores.begin() + index, scores.begin() + index + 1);
+        }
+    }
+
+    const double alphaOrig = alpha;
+    PackedMove bestMove;
+    double maxEval = -1e11;
+    int bestIndex = -1;
+
+    // 在根节点进行主要变例搜索: 第一步用完整窗口, 其余走法先用零窗口试探是否优于当前最佳(子节点为叶节点时除外)
+    for (int i = 0; i < moves.size(); i++) {
+        const PackedMove move = moves[i];
+        // 在沙盘执行一步
+        makeMoveInSandbox(move);
+        root.currentMove = move;
+        // 递归调用 Alpha-Beta，当前是 Max 层，下一层是 Min 层
+        double eval;
+        if (i == 0 || depth == moveDepth()) {
+            eval = searchReply(1, depth - moveDepth(), alpha, beta, false);
+        } else {
+            eval = searchReply(1, depth - moveDepth(), alpha, std::nextafter(alpha, beta), false);
+            if (eval > alpha && eval < beta && !stopped()) {
+                eval = searchReply(1, depth - moveDepth(), alpha, beta, false);
+            }
+        }
+        // 撤销一步
+        unmakeMoveInSandbox(move);
+
+        // 时间用完, 该走法的评分不完整
+        if (stopped()) break;
+
+        if (eval > maxEval) {
+            maxEval = eval;
+            bestMove = move;
+            bestIndex = i;
+        }
+
+        // 更新 Alpha 与主要变例
+        if (eval > alpha) {
+            alpha = eval;
+            updatePv(0, move);
+        }
+        // 评分超出期望窗口上界, 由迭代加深放宽窗口后重新搜索
+        if (alpha >= beta) break;
+
+        // 第一步搜索完毕, 其余根节点走法交给空闲线程分担
+        if (canSplit(depth)) {
+            SplitPoint<N> &split = openSplit(0, depth, true, alpha, beta, maxEval, bestMove, i + 1);
+            split.moves = &moves;
+            split.nextIndex = i + 1;
+            runSplit(split);
+            alpha = split.alpha;
+            maxEval = split.bestEval;
+            bestMove = split.bestMove;
+            bestIndex = static_cast<int>(std::find(moves.begin(), moves.end(), bestMove) - moves.begin());
+            break;
+        }
+    }
+    // 标记本次迭代的最佳走法, 下一次迭代排在最前
+    std::replace(scores.begin(), scores.begin() + moves.size(), std::numeric_limits<int>::max(), 0);
+    if (bestIndex >= 0 && bestIndex < moves.size()) scores[bestIndex] = std::numeric_limits<int>::max();
+
+    // 如果没有找到有效走法，返回空
+    if (bestMove.isNull() && !moves.isEmpty()) {
+        return moves[0];
+    }
+
+    score = maxEval;
+    // 只有落在窗口内的评分才是精确值
+    if (!stopped() && maxEval > alphaOrig && maxEval < beta) {
+        m_tt->store(m_sandbox.key, depth, maxEval, TranspositionTable<N>::Exact, bestMove);
+    }
+
+    return bestMove;
+}
+
+template <int N>
+void Search<N>::updatePv(int ply, PackedMove move)
+{
+    typename SearchStack<N>::Ply &current = m_stack->ply(ply);
+    const typename SearchStack<N>::Ply &child = m_stack->ply(ply + 1);
+    current.pv[0] = move;
+    for (int i = 0; i < child.pvLength; i++) current.pv[i + 1] = child.pv[i];
+    current.pvLength = child.pvLength + 1;
+}
+
+template <int N>
+double Search<N>::alphaBeta(int ply, int depth, double alpha, double beta, bool maximizingPlayer)
+{
+    m_nodes++;
+    checkTime();
+    if (aborted()) return 0.0;
+
+    typename SearchStack<N>::Ply &plyData = m_stack->ply(ply);
+    plyData.pvLength = 0;
+
+    // 终止条件：达到深度或游戏结束
+    if (depth == 0) {
+        return evalSandbox();
+    }
+
+    // 确定当前模拟的是谁的走法
+    bool currentSideIsWhite = maximizingPlayer ? m_isWhite : !m_isWhite;
+
+    // 终局判断无需生成走法: 当前回合方无路可走
+    // 如果是 maximizingPlayer 无路可走，说明AI输了，返回极小值
+    // 如果是 minimizingPlayer 无路可走，说明对手输了，返回极大值
+    if (!m_sandbox.canMove(currentSideIsWhite)) {
+        return maximizingPlayer ? -1e10 : 1e10;
+    }
+
+    // 查询置换表: 深度足够且记录的评分已落在窗口之外(或为精确值)时直接返回, 否则只取其最佳走法用于排序
+    const double alphaOrig = alpha;
+    const double betaOrig = beta;
+    PackedMove hashMove;
+    typename TranspositionTable<N>::Entry entry;
+    if (m_tt->probe(m_sandbox.key, entry, m_hashStats)) {
+        hashMove = entry.move;
+        if (entry.depth >= depth
+            && (entry.bound == TranspositionTable<N>::Exact
+                || (entry.bound == TranspositionTable<N>::Lower && entry.score >= beta)
+                || (entry.bound == TranspositionTable<N>::Upper && entry.score <= alpha))) {
+            return entry.score;
+        }
+    }
+
+    // 无效剪枝: 前沿节点的静态评估加上余量仍不能越过窗口时, 认为其走法都不会改变结果
+    const SearchOptions &options = m_main->m_options;
+    if (options.futilityMargin > 0 && depth <= options.futilityDepth) {
+        const double margin = options.futilityMargin * depth;
+        const double staticEval = evalSandbox();
+        if (maximizingPlayer ? staticEval + margin <= alpha : staticEval - margin >= beta) {
+            return maximizingPlayer ? staticEval + margin : staticEval - margin;
+        }
+    }
+
+    // 分阶段给出当前回合方的走法: 置换表走法、杀手走法、反制走法, 然后其余走法按历史得分排序
+    // 前几个阶段引起剪枝时不必生成全部走法
+    const PackedMove counterMove = m_counterMoves->get(m_stack->ply(ply - 1).currentMove);
+    MovePicker<N> picker(m_sandbox, getSearchablePieces(m_sandbox, currentSideIsWhite, m_regions), currentSideIsWhite,
+                         hashMove, plyData.killers, counterMove, *m_history, plyData.moves, plyData.scores);
+    PackedMove move;
+
+    // 可移动的棋子均已处于封闭区域, 同样按无路可走处理
+    if (!picker.next(move)) {
+        return maximizingPlayer ? -1e10 : 1e10;
+    }
+
+    double bestEval;
+    PackedMove bestMove;
+    int moveIndex = 0;
+    const int width = beamWidth(depth);
+    // 主要变例搜索: 第一步用完整窗口, 其余走法先用零窗口试探, 只有试探结果落入窗口内才重新完整搜索
+    // 子节点为叶节点时评估本身就是精确值, 零窗口试探没有意义
+    if (maximizingPlayer) {
+        bestEval = -1e11;
+        do {
+            makeMoveInSandbox(move);
+            plyData.currentMove = move;
+            double eval;
+            if (moveIndex == 0 || depth == 1) {
+                eval = alphaBeta(ply + 1, depth - 1, alpha, beta, false);
+            } else {
+                eval = searchSibling(ply + 1, depth - 1, lateMoveReduction(depth, moveIndex), alpha, beta, true);
+            }
+            unmakeMoveInSandbox(move);
+            if (aborted()) return bestEval; // 时间用完, 结果不完整也不写入置换表
+
+            if (eval > bestEval) {
+                bestEval = eval;
+                bestMove = move;
+            }
+            if (eval > alpha) {
+                alpha = eval;
+                updatePv(ply, move);
+            }
+
+            // Beta 剪枝：对手已经找到了一个比当前路径更坏(对AI来说)的选项
+            // 所以对手绝对不会让局面到达现在的 alpha 状态
+            if (beta <= alpha) {
+                recordCutoff(ply, depth, currentSideIsWhite, move, moveIndex, m_stack->ply(ply - 1).currentMove);
+                break;
+            }
+            moveIndex++;
+            // 束宽以内的走法已全部搜索
+            if (width > 0 && moveIndex >= width) break;
+
+            // 长子已搜索完毕且没有剪枝, 其余兄弟走法交给空闲线程分担
+            if (canSplit(depth)) {
+                picker.generateAll();
+                SplitPoint<N> &split = openSplit(ply, depth, true, alpha, beta, bestEval, bestMove, moveIndex);
+                split.picker = &picker;
+                split.moveLimit = width;
+                runSplit(split);
+                if (aborted()) return bestEval;
+                alpha = split.alpha;
+                bestEval = split.bestEval;
+                bestMove = split.bestMove;
+                break;
+            }
+        } while (picker.next(move));
+    } else {
+        bestEval = 1e11;
+        do {
+            makeMoveInSandbox(move);
+            plyData.currentMove = move;
+            double eval;
+            if (moveIndex == 0 || depth == 1) {
+                eval = alphaBeta(ply + 1, depth - 1, alpha, beta, true);
+            } else {
+                eval = searchSibling(ply + 1, depth - 1, lateMoveReduction(depth, moveIndex), alpha, beta, false);
+            }
+            unmakeMoveInSandbox(move);
+            if (aborted()) return bestEval; // 时间用完, 结果不完整也不写入置换表
+
+            if (eval < bestEval) {
+                bestEval = eval;
+                bestMove = move;
+            }
+            if (eval < beta) {
+                beta = eval;
+                updatePv(ply, move);
+            }
+
+            // Alpha 剪枝：AI 已经找到了一个比当前路径更好(对AI来说)的选项
+            // 所以 AI 绝不会选择进入这个分支
+            if (beta <= alpha) {
+                recordCutoff(ply, depth, currentSideIsWhite, move, moveIndex, m_stack->ply(ply - 1).currentMove);
+                break;
+            }
+            moveIndex++;
+            if (width > 0 && moveIndex >= width) break;
+
+            if (canSplit(depth)) {
+                picker.generateAll();
+                SplitPoint<N> &split = openSplit(ply, depth, false, alpha, beta, bestEval, bestMove, moveIndex);
+                split.picker = &picker;
+                split.moveLimit = width;
+                runSplit(split);
+                if (aborted()) return bestEval;
+                beta = split.beta;
+                bestEval = split.bestEval;
+                bestMove = split.bestMove;
+                break;
+            }
+        } while (picker.next(move));
+    }
+
+    // 写入置换表: 评分相对于进入本节点时的窗口确定界类型
+    typename TranspositionTable<N>::Bound bound = TranspositionTable<N>::Exact;
+    if (bestEval <= alphaOrig) {
+        bound = TranspositionTable<N>::Upper;
+    } else if (bestEval >= betaOrig) {
+        bound = TranspositionTable<N>::Lower;
+    }
+    // 所有走法都不超过 Alpha(或都不低于 Beta)时没有可信的最佳走法
+    m_tt->store(m_sandbox.key, depth, bestEval, bound,
+               bound == (maximizingPlayer ? TranspositionTable<N>::Upper : TranspositionTable<N>::Lower) ? PackedMove() : bestMove);
+    return bestEval;
+}
+
+template <int N>
+void Search<N>::recordCutoff(int ply, int depth, bool isWhite, PackedMove move, int moveIndex, PackedMove previousMove)
+{
+    m_info.cutoffs++;
+    if (moveIndex == 0) m_info.firstMoveCutoffs++;
+
+    std::array<PackedMove, 2> &killers = m_stack->ply(ply).killers;
+    if (killers[0] != move) {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+    m_history->reward(isWhite, move, depth);
+    m_counterMoves->set(previousMove, move);
+}
+
+template <int N>
+int Search<N>::beamWidth(int depth) const
+{
+    const QVector<int> &widths = m_main->m_options.beamWidths;
+    return depth >= 1 && depth <= widths.size() ? widths[depth - 1] : 0;
+}
+
+template <int N>
+int Search<N>::lateMoveReduction(int depth, int moveIndex) const
+{
+    const SearchOptions &options = m_main->m_options;
+    if (options.lmrMinDepth <= 0 || depth < options.lmrMinDepth || moveIndex < options.lmrMoveIndex) return 0;
+    // 至少保留一层, 子节点不直接变成叶节点
+    return qBound(0, options.lmrReduction, depth - 2);
+}
+
+template <int N>
+double Search<N>::searchSibling(int ply, int depth, int reduction, double alpha, double beta, bool maximizingPlayer)
+{
+    double eval;
+    if (maximizingPlayer) {
+        eval = searchReply(ply, depth - reduction, alpha, std::nextafter(alpha, beta), false);
+        // 少搜的试探超过了 alpha, 以完整深度再试探一次
+        if (reduction > 0 && eval > alpha && !aborted()) {
+            eval = searchReply(ply, depth, alpha, std::nextafter(alpha, beta), false);
+        }
+        if (eval > alpha && eval < beta && !aborted()) {
+            eval = searchReply(ply, depth, alpha, beta, false);
+        }
+    } else {
+        eval = searchReply(ply, depth - reduction, std::nextafter(beta, alpha), beta, true);
+        if (reduction > 0 && eval < beta && !aborted()) {
+            eval = searchReply(ply, depth, std::nextafter(beta, alpha), beta, true);
+        }
+        if (eval < beta && eval > alpha && !aborted()) {
+            eval = searchReply(ply, depth, alpha, beta, true);
+        }
+    }
+    return eval;
+}
+
+template <int N>
+double Search<N>::searchReply(int ply, int depth, double alpha, double beta, bool maximizingPlayer)
+{
+    return m_main->m_halfPly ? queenPly(ply, depth, alpha, beta, maximizingPlayer)
+                             : alphaBeta(ply, depth, alpha, beta, maximizingPlayer);
+}
+
+template <int N>
+double Search<N>::queenPly(int ply, int depth, double alpha, double beta, bool maximizingPlayer)
+{
+    m_nodes++;
+    checkTime();
+    if (aborted()) return 0.0;
+
+    typename SearchStack<N>::Ply &plyData = m_stack->ply(ply);
+    plyData.pvLength = 0;
+    if (depth == 0) {
+        return evalSandbox();
+    }
+
+    const bool currentSideIsWhite = maximizingPlayer ? m_isWhite : !m_isWhite;
+    if (!m_sandbox.canMove(currentSideIsWhite)) {
+        return maximizingPlayer ? -1e10 : 1e10;
+    }
+
+    // 与 alphaBeta 相同地查询置换表, 最佳走法只取其皇后步
+    const double alphaOrig = alpha;
+    const double betaOrig = beta;
+    PackedMove hashMove;
+    typename TranspositionTable<N>::Entry entry;
+    if (m_tt->probe(m_sandbox.key, entry, m_hashStats)) {
+        hashMove = entry.move;
+        if (entry.depth >= depth
+            && (entry.bound == TranspositionTable<N>::Exact
+                || (entry.bound == TranspositionTable<N>::Lower && entry.score >= beta)
+                || (entry.bound == TranspositionTable<N>::Upper && entry.score <= alpha))) {
+            return entry.score;
+        }
+    }
+
+    // 生成全部皇后步(射箭点记为起点, 不使用), 置换表走法的皇后步最先, 其余按历史得分排序
+    MoveList<N> &steps = plyData.moves;
+    steps.clear();
+    const Bitboard empty = m_sandbox.empty();
+    Bitboard pieces = getSearchablePieces(m_sandbox, currentSideIsWhite, m_regions);
+    while (pieces) {
+        const int from = popLsb(pieces);
+        Bitboard targets = queenReach<N>(from, empty);
+        while (targets) {
+            const int to = popLsb(targets);
+            const bool isHashMove = !hashMove.isNull() && hashMove.from() == from && hashMove.to() == to;
+            plyData.scores[steps.size()] = isHashMove ? std::numeric_limits<int>::max()
+                                                      : m_history->queenScore(currentSideIsWhite, from, to);
+            steps.append(PackedMove(from, to, from));
+        }
+    }
+    // 可移动的棋子均已处于封闭区域, 按无路可走处理
+    if (steps.isEmpty()) {
+        return maximizingPlayer ? -1e10 : 1e10;
+    }
+    sortByScore(steps, plyData.scores);
+
+    double bestEval = maximizingPlayer ? -1e11 : 1e11;
+    PackedMove bestMove;
+    const typename SearchStack<N>::Ply &child = m_stack->ply(ply + 1);
+    for (int i = 0; i < steps.size(); i++) {
+        const int from = steps[i].from();
+        const int to = steps[i].to();
+        m_sandbox.movePiece(from, to);
+        // 射箭层与本层属于同一方, 窗口不变; 其余皇后步同样先用零窗口试探
+        double eval;
+        if (i == 0 || depth == 1) {
+            eval = arrowPly(ply + 1, depth - 1, alpha, beta, maximizingPlayer, from, to);
+        } else {
+            eval = maximizingPlayer ? arrowPly(ply + 1, depth - 1, alpha, std::nextafter(alpha, beta), true, from, to)
+                                    : arrowPly(ply + 1, depth - 1, std::nextafter(beta, alpha), beta, false, from, to);
+            if (eval > alpha && eval < beta && !aborted()) {
+                eval = arrowPly(ply + 1, depth - 1, alpha, beta, maximizingPlayer, from, to);
+            }
+        }
+        m_sandbox.movePiece(to, from);
+        if (aborted()) return bestEval; // 时间用完, 结果不完整也不写入置换表
+
+        if (maximizingPlayer ? eval > bestEval : eval < bestEval) {
+            bestEval = eval;
+            // 射箭层的主要变例以完整走法开头; 射箭层没有展开时只记下皇后步
+            bestMove = child.pvLength > 0 ? child.pv[0] : steps[i];
+        }
+        if (maximizingPlayer ? eval > alpha : eval < beta) {
+            (maximizingPlayer ? alpha : beta) = eval;
+            std::copy(child.pv.begin(), child.pv.begin() + child.pvLength, plyData.pv.begin());
+            plyData.pvLength = child.pvLength;
+        }
+        if (beta <= alpha) {
+            m_info.cutoffs++;
+            if (i == 0) m_info.firstMoveCutoffs++;
+            m_history->rewardQueen(currentSideIsWhite, from, to, depth);
+            break;
+        }
+    }
+
+    typename TranspositionTable<N>::Bound bound = TranspositionTable<N>::Exact;
+    if (bestEval <= alphaOrig) {
+        bound = TranspositionTable<N>::Upper;
+    } else if (bestEval >= betaOrig) {
+        bound = TranspositionTable<N>::Lower;
+    }
+    m_tt->store(m_sandbox.key, depth, bestEval, bound,
+               bound == (maximizingPlayer ? TranspositionTable<N>::Upper : TranspositionTable<N>::Lower) ? PackedMove() : bestMove);
+    return bestEval;
+}
+
+template <int N>
+double Search<N>::arrowPly(int ply, int depth, double alpha, double beta, bool maximizingPlayer, int from, int to)
+{
+    m_nodes++;
+    checkTime();
+    if (aborted()) return 0.0;
+
+    typename SearchStack<N>::Ply &plyData = m_stack->ply(ply);
+    plyData.pvLength = 0;
+    // 剩余深度在皇后步之后用完: 不展开射箭, 直接评估皇后已落下的局面
+    if (depth == 0) {
+        return evalSandbox();
+    }
+
+    // 射箭待定的局面以射箭的皇后所在格子区分哈希值, 不与完整局面混淆
+    const bool currentSideIsWhite = maximizingPlayer ? m_isWhite : !m_isWhite;
+    const quint64 key = m_sandbox.key ^ Zobrist.pendingArrow[to];
+    const double alphaOrig = alpha;
+    const double betaOrig = beta;
+    int hashArrow = -1;
+    typename TranspositionTable<N>::Entry entry;
+    if (m_tt->probe(key, entry, m_hashStats)) {
+        if (!entry.move.isNull()) hashArrow = entry.move.arrow();
+        if (entry.depth >= depth
+            && (entry.bound == TranspositionTable<N>::Exact
+                || (entry.bound == TranspositionTable<N>::Lower && entry.score >= beta)
+                || (entry.bound == TranspositionTable<N>::Upper && entry.score <= alpha))) {
+            return entry.score;
+        }
+    }
+
+    // 皇后刚离开的起点总能射到, 射箭点不会为空
+    MoveList<N> &arrows = plyData.moves;
+    arrows.clear();
+    Bitboard targets = queenReach<N>(to, m_sandbox.empty());
+    while (targets) {
+        const int arrow = popLsb(targets);
+        plyData.scores[arrows.size()] = arrow == hashArrow ? std::numeric_limits<int>::max()
+                                                           : m_history->arrowScore(currentSideIsWhite, to, arrow);
+        arrows.append(PackedMove(from, to, arrow));
+    }
+    sortByScore(arrows, plyData.scores);
+
+    double bestEval = maximizingPlayer ? -1e11 : 1e11;
+    PackedMove bestMove;
+    for (int i = 0; i < arrows.size(); i++) {
+        const PackedMove move = arrows[i];
+        // 射箭并换边, 此时沙盒与执行完整走法后相同
+        m_sandbox.placeArrow(move.arrow());
+        m_sandbox.setWhiteToMove(!m_sandbox.whiteToMove);
+        m_regions.placeArrow(m_sandbox, move.arrow());
+        plyData.currentMove = move;
+        double eval;
+        if (i == 0 || depth == 1) {
+            eval = queenPly(ply + 1, depth - 1, alpha, beta, !maximizingPlayer);
+        } else {
+            eval = maximizingPlayer ? queenPly(ply + 1, depth - 1, alpha, std::nextafter(alpha, beta), false)
+                                    : queenPly(ply + 1, depth - 1, std::nextafter(beta, alpha), beta, true);
+            if (eval > alpha && eval < beta && !aborted()) {
+                eval = queenPly(ply + 1, depth - 1, alpha, beta, !maximizingPlayer);
+            }
+        }
+        m_regions.undo();
+        m_sandbox.setWhiteToMove(!m_sandbox.whiteToMove);
+        m_sandbox.removeArrow(move.arrow());
+        if (aborted()) return bestEval;
+
+        if (maximizingPlayer ? eval > bestEval : eval < bestEval) {
+            bestEval = eval;
+            bestMove = move;
+        }
+        if (maximizingPlayer ? eval > alpha : eval < beta) {
+            (maximizingPlayer ? alpha : beta) = eval;
+            updatePv(ply, move);
+        }
+        if (beta <= alpha) {
+            m_info.cutoffs++;
+            if (i == 0) m_info.firstMoveCutoffs++;
+            m_history->rewardArrow(currentSideIsWhite, to, move.arrow(), depth);
+            break;
+        }
+    }
+
+    typename TranspositionTable<N>::Bound bound = TranspositionTable<N>::Exact;
+    if (bestEval <= alphaOrig) {
+        bound = TranspositionTable<N>::Upper;
+    } else if (bestEval >= betaOrig) {
+        bound = TranspositionTable<N>::Lower;
+    }
+    m_tt->store(key, depth, bestEval, bound,
+               bound == (maximizingPlayer ? TranspositionTable<N>::Upper : TranspositionTable<N>::Lower) ? PackedMove() : bestMove);
+    return bestEval;
+}
+
+template <int N>
+void Search<N>::sortRootMoves(MoveList<N> &moves, std::array<int, MoveList<N>::Capacity> &scores)
+{
+    // 根节点走法可达数千个, 对索引排序后再重排; 得分相同时按原顺序, 效果同稳定排序但不申请临时缓冲区
+    const int count = moves.size();
+    std::array<int, MoveList<N>::Capacity> order;
+    for (int i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.begin() + count, [&scores](int a, int b) {
+        return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+    });
+    std::array<PackedMove, MoveList<N>::Capacity> sortedMoves;
+    std::array<int, MoveList<N>::Capacity> sortedScores;
+    for (int i = 0; i < count; i++) {
+        sortedMoves[i] = moves[order[i]];
+        sortedScores[i] = scores[order[i]];
+    }
+    std::copy(sortedMoves.begin(), sortedMoves.begin() + count, moves.begin());
+    std::copy(sortedScores.begin(), sortedScores.begin() + count, scores.begin());
+}
+
+template <int N>
+void Search<N>::sortByScore(MoveList<N> &moves, std::array<int, MoveList<N>::Capacity> &scores)
+{
+    for (int i = 1; i < moves.size(); i++) {
+        const PackedMove move = moves[i];
+        const int score = scores[i];
+        int j = i;
+        for (; j > 0 && scores[j - 1] < score; j--) {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
+}
+
+template <int N>
+bool Search<N>::canSplit(int depth) const
+{
+    return m_main->m_parallelMode == ParallelMode::YoungBrothersWait
+           && depth >= MinSplitDepth
+           && m_splitPoints
+           && m_splitCount < SearchStack<N>::MaxPly
+           && m_main->m_idleHelpers.load(std::memory_order_relaxed) > 0
+           && !aborted();
+}
+
+template <int N>
+SplitPoint<N> &Search<N>::openSplit(int ply, int depth, bool maximizingPlayer, double alpha, double beta,
+                                    double bestEval, PackedMove bestMove, int moveIndex)
+{
+    // 尚未公开, 填写时不必加锁
+    SplitPoint<N> &split = m_splitPoints[m_splitCount];
+    split.parent = m_activeSplit;
+    split.position = m_sandbox;
+    split.regions = m_regions;
+    split.ply = ply;
+    split.depth = depth;
+    split.maximizing = maximizingPlayer;
+    split.isWhite = maximizingPlayer ? m_isWhite : !m_isWhite;
+    split.previousMove = ply > 0 ? m_stack->ply(ply - 1).currentMove : PackedMove();
+    split.picker = nullptr;
+    split.moves = nullptr;
+    split.nextIndex = 0;
+    split.moveIndex = moveIndex;
+    split.moveLimit = 0;
+    split.alpha = alpha;
+    split.beta = beta;
+    split.bestEval = bestEval;
+    split.bestMove = bestMove;
+    const typename SearchStack<N>::Ply &plyData = m_stack->ply(ply);
+    std::copy(plyData.pv.begin(), plyData.pv.begin() + plyData.pvLength, split.pv.begin());
+    split.pvLength = plyData.pvLength;
+    split.finished = false;
+    split.cutoff = false;
+    split.workers = 0;
+    return split;
+}
+
+template <int N>
+void Search<N>::runSplit(SplitPoint<N> &split)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_splitMutex);
+        m_splitCount++;
+    }
+
+    SplitPoint<N> *const previous = m_activeSplit;
+    m_activeSplit = &split;
+    searchSplit(split);
+    m_activeSplit = previous;
+
+    // 自己领不到走法后不再接受新的线程, 等待已加入的线程搜索完手头的走法
+    {
+        std::lock_guard<std::mutex> lock(split.mutex);
+        split.finished = true;
+    }
+    while (split.workers.load(std::memory_order_acquire) > 0) {
+        if (m_main == this && limitReached()) m_stopFlag = true;
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_splitMutex);
+        m_splitCount--;
+    }
+
+    typename SearchStack<N>::Ply &plyData = m_stack->ply(split.ply);
+    std::copy(split.pv.begin(), split.pv.begin() + split.pvLength, plyData.pv.begin());
+    plyData.pvLength = split.pvLength;
+}
+
+template <int N>
+void Search<N>::searchSplit(SplitPoint<N> &split)
+{
+    typename SearchStack<N>::Ply &plyData = m_stack->ply(split.ply);
+    const int ply = split.ply + 1;
+    const int depth = split.depth - moveDepth();
+
+    while (true) {
+        PackedMove move;
+        int moveIndex;
+        double alpha;
+        double beta;
+        {
+            std::lock_guard<std::mutex> lock(split.mutex);
+            if (split.finished || !split.nextMove(move)) {
+                split.finished = true;
+                return;
+            }
+            moveIndex = split.moveIndex++;
+            alpha = split.alpha;
+            beta = split.beta;
+        }
+
+        // 与串行搜索相同, 兄弟走法先用零窗口试探; 窗口取领取时的最新值
+        makeMoveInSandbox(move);
+        plyData.currentMove = move;
+        const int reduction = split.ply > 0 ? lateMoveReduction(split.depth, moveIndex) : 0;
+        const double eval = searchSibling(ply, depth, reduction, alpha, beta, split.maximizing);
+        unmakeMoveInSandbox(move);
+        if (aborted()) return;
+
+        std::lock_guard<std::mutex> lock(split.mutex);
+        if (split.maximizing ? eval > split.bestEval : eval < split.bestEval) {
+            split.bestEval = eval;
+            split.bestMove = move;
+        }
+        if (split.maximizing ? eval > split.alpha : eval < split.beta) {
+            (split.maximizing ? split.alpha : split.beta) = eval;
+            // 主要变例: 本步接上本线程下一层的主要变例
+            const typename SearchStack<N>::Ply &child = m_stack->ply(ply);
+            split.pv[0] = move;
+            std::copy(child.pv.begin(), child.pv.begin() + child.pvLength, split.pv.begin() + 1);
+            split.pvLength = child.pvLength + 1;
+        }
+        if (split.beta <= split.alpha) {
+            // 剪枝: 其余线程正在搜索的兄弟子树随之作废
+            split.cutoff = true;
+            split.finished = true;
+            if (split.ply > 0) recordCutoff(split.ply, split.depth, split.isWhite, move, moveIndex, split.previousMove);
+            return;
+        }
+    }
+}
+
+template <int N>
+SplitPoint<N> *Search<N>::stealSplit()
+{
+    // 依次查看各线程的分裂点, 从最浅的开始
+    for (int i = -1; i < static_cast<int>(m_main->m_helpers.size()); i++) {
+        Search *owner = i < 0 ? m_main : m_main->m_helpers[i].get();
+        if (owner == this) continue;
+
+        std::lock_guard<std::mutex> ownerLock(owner->m_splitMutex);
+        for (int j = 0; j < owner->m_splitCount; j++) {
+            SplitPoint<N> &split = owner->m_splitPoints[j];
+            std::lock_guard<std::mutex> lock(split.mutex);
+            if (split.finished || split.cancelled()) continue;
+            split.workers.fetch_add(1, std::memory_order_relaxed);
+            return &split;
+        }
+    }
+    return nullptr;
+}
+
+template <int N>
+void Search<N>::helperWaitForWork()
+{
+    resetThreadState();
+    m_main->m_idleHelpers++;
+    while (!stopped()) {
+        SplitPoint<N> *split = stealSplit();
+        if (!split) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // 复制分裂点的局面后与其创建者一起领取走法
+        m_main->m_idleHelpers--;
+        m_sandbox = split->position;
+        m_regions = split->regions;
+        m_activeSplit = split;
+        searchSplit(*split);
+        m_activeSplit = nullptr;
+        split->workers.fetch_sub(1, std::memory_order_release);
+        m_main->m_idleHelpers++;
+    }
+    m_main->m_idleHelpers--;
+}
+
+template <int N>
+void Search<N>::generateLegalMoves(bool isWhite, MoveList<N> &moves) const
+{
+    generateLegalMoves(m_sandbox, isWhite, m_regions, moves);
+}
+
+template <int N>
+typename Search<N>::Bitboard Search<N>::getSearchablePieces(const Position &position, bool isWhite, const RegionTracker &regions) const
+{
+    Bitboard pieces = position.pieces(isWhite);
+    if (m_endgame) return pieces;
+
+    // 官子阶段检查: 非官子阶段跳过封闭区域
+    Bitboard result{};
+    while (pieces) {
+        int square = popLsb(pieces);
+        if (!regions.isEnclosed(square, isWhite)) {
+            result |= Geometry::squareBit(square);
+        }
+    }
+    return result;
+}
+
+template <int N>
+void Search<N>::generateLegalMoves(const Position &position, bool isWhite, const RegionTracker &regions, MoveList<N> &moves) const
+{
+    moves.clear();
+
+    MoveGenerator<N> generator(position, getSearchablePieces(position, isWhite, regions));
+    PackedMove move;
+    while (generator.next(move)) {
+        moves.append(move);
+    }
+}
+
+template class Search<8>;
+template class Search<10>;
@@ -0,0 +1,375 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <QVector>
+#include <QSet>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include "regiontracker.h"
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "movegenerator.h"
+#include "movelist.h"
+#include "movepicker.h"
+#include "transpositiontable.h"
+#include "splitpoint.h"
+
+// 评估函数权重
+struct EvalWeights
+{
+    // 移动性权重与指数
+    double mobilityWeight;
+    double mobilityExponent;
+
+    // 射箭灵活性权重与指数
+    double shootFlexibilityWeight;
+    double shootExponent;
+
+    // 领地面积权重
+    double territoryWeight;
+
+    // 中心控制权重
+    double centerControlWeight;
+
+    // 棋子分散性权重
+    double dispersionWeight;
+
+    // 构造函数初始化列表
+    EvalWeights() :
+        mobilityWeight(1.0),
+        mobilityExponent(0.5),
+        shootFlexibilityWeight(0.6),
+        shootExponent(0.4),
+        territoryWeight(2.0),
+        centerControlWeight(0.5),
+        dispersionWeight(0.3)
+    {}
+    EvalWeights(double mobilityW, double mobilityE,
+                double shootW, double shootE,
+                double territoryW,
+                double centerW,
+                double dispersionW) :
+        mobilityWeight(mobilityW),
+        mobilityExponent(mobilityE),
+        shootFlexibilityWeight(shootW),
+        shootExponent(shootE),
+        territoryWeight(territoryW),
+        centerControlWeight(centerW),
+        dispersionWeight(dispersionW)
+    {}
+
+    // 结构体 -> QJsonObject
+    QJsonObject toJson() const
+    {
+        QJsonObject obj;
+        obj["mobilityWeight"]          = mobilityWeight;
+        obj["mobilityExponent"]        = mobilityExponent;
+        obj["shootFlexibilityWeight"]  = shootFlexibilityWeight;
+        obj["shootExponent"]           = shootExponent;
+        obj["territoryWeight"]         = territoryWeight;
+        obj["centerControlWeight"]     = centerControlWeight;
+        obj["dispersionWeight"]        = dispersionWeight;
+        return obj;
+    }
+
+    // QJsonObject -> 结构体
+    void fromJson(const QJsonObject &obj)
+    {
+        mobilityWeight          = obj["mobilityWeight"].toDouble();
+        mobilityExponent        = obj["mobilityExponent"].toDouble();
+        shootFlexibilityWeight  = obj["shootFlexibilityWeight"].toDouble();
+        shootExponent           = obj["shootExponent"].toDouble();
+        territoryWeight         = obj["territoryWeight"].toDouble();
+        centerControlWeight     = obj["centerControlWeight"].toDouble();
+        dispersionWeight        = obj["dispersionWeight"].toDouble();
+    }
+};
+
+// 单次搜索的限制: 迭代加深直到达到最大深度或用完时间预算
+struct SearchLimits
+{
+    int maxDepth = 64;  // 最大迭代深度
+    qint64 timeMs = 0;  // 每步时间预算(毫秒), 0 表示不限时间
+    const std::atomic<bool> *cancel = nullptr; // 取消令牌, 由其他线程置位后搜索尽快中止
+    // 后台思考标志: 为真时不受时间预算限制; 由其他线程清零后, 已用掉的时间计入预算
+    const std::atomic<bool> *ponder = nullptr;
+};
+
+// 选择性搜索的参数: 以少量误差换取更深的搜索, 默认全部关闭即全宽搜索
+// 只作用于 alphaBeta 的内部节点, 根节点与半步搜索总是全宽
+struct SearchOptions
+{
+    // 束搜索: beamWidths[d - 1] 为剩余深度 d 的节点最多搜索的走法数, 按走法排序取前若干个
+    // 0 或超出列表长度表示不限
+    QVector<int> beamWidths;
+    // 后期走法减少(LMR): 剩余深度不小于 lmrMinDepth 的节点中, 序号不小于 lmrMoveIndex 的走法先少搜 lmrReduction 层,
+    // 零窗口试探失败高时再以完整深度重新搜索; lmrMinDepth 为 0 时关闭
+    int lmrMinDepth = 0;
+    int lmrMoveIndex = 4;
+    int lmrReduction = 1;
+    // 无效剪枝: 剩余深度不超过 futilityDepth 的节点, 静态评估加上 futilityMargin 乘以剩余深度仍不能越过窗口时
+    // 不再搜索其走法; 余量为 0 时关闭
+    double futilityMargin = 0.0;
+    int futilityDepth = 1;
+};
+
+// 多线程搜索的并行方式
+enum class ParallelMode
+{
+    LazySmp,          // 各线程独立搜索同一根局面, 只通过共享置换表协作
+    YoungBrothersWait // 分裂树: 节点的第一个子节点串行搜索后, 其余兄弟走法由空闲线程分担
+};
+
+// 最近一次搜索的结果信息
+struct SearchInfo
+{
+    int depth = 0;      // 最后完成的迭代深度
+    double score = 0.0; // 该深度下最佳走法的评分
+    quint64 nodes = 0;  // 搜索的节点总数(含未完成的迭代)
+    qint64 timeMs = 0;  // 总耗时(毫秒)
+
+    // 走法排序效果: 发生剪枝的节点数, 以及其中由第一步走法引起剪枝的节点数
+    quint64 cutoffs = 0;
+    quint64 firstMoveCutoffs = 0;
+    double firstMoveCutoffRate() const { return cutoffs == 0 ? 0.0 : static_cast<double>(firstMoveCutoffs) / cutoffs; }
+};
+
+// N x N 棋盘上的AI搜索, 与界面无关
+// 以根局面为起点, 在沙盒局面上通过 make/unmake 做 Alpha-Beta 搜索与官子阶段的回溯
+// 成员函数定义于 search.cpp, 在其中显式实例化 8x8 与 10x10
+template <int N>
+class Search
+{
+public:
+    using Geometry = BoardGeometry<N>;
+    using Bitboard = BitboardOf<N>;
+    using Position = BasicPosition<N>;
+    using PackedMove = BasicPackedMove<N>;
+    using RegionTracker = BasicRegionTracker<N>;
+
+    // 所有可能的走法
+    struct AllMoves
+    {
+        // 我方四个棋子的位置
+        std::array<QPair<int, int>, 4> positions;
+        // 对应棋子的所有可行动范围
+        std::array<MoveRange, 4> moves;
+        // 所有移动方式总数 (排除被封闭的棋子))
+        int moveOpts = 0;
+        // 所有行棋方式总数, 即每种移动方式后的射箭方式数之和 (排除被封闭的棋子)
+        int actionCount = 0;
+
+        // 是否处于官子阶段
+        bool isEndgame() const {
+            return (moves[0].inClosedRegion() || !moves[0].canMove())
+                   && (moves[1].inClosedRegion() || !moves[1].canMove())
+                   && (moves[2].inClosedRegion() || !moves[2].canMove())
+                   && (moves[3].inClosedRegion() || !moves[3].canMove());
+        }
+    };
+
+    explicit Search(bool isWhite = false, EvalWeights weights = EvalWeights());
+
+    EvalWeights getWeights() const { return m_weights; }
+
+    // 设置根局面(真实棋盘状态), 沙盒随之重置
+    void setRootPosition(const Position &position);
+    // 重置搜索状态(官子阶段记录等)
+    void reset();
+
+    // 置换表大小(MB), 重新设置时清空已有内容
+    void setHashSize(int sizeMB) { m_tt->resize(sizeMB); }
+    int hashSize() const { return m_tt->sizeMB(); }
+    void clearHash() { m_tt->clear(); }
+    // 最近一次搜索(所有线程合计)的置换表查询与命中次数
+    const typename TranspositionTable<N>::Stats &hashStats() const { return m_hashStats; }
+
+    // 搜索线程数: 除当前线程外另开 count - 1 个辅助线程, 按 parallelMode 分担搜索
+    void setThreadCount(int count);
+    int threadCount() const { return static_cast<int>(m_helpers.size()) + 1; }
+    void setParallelMode(ParallelMode mode) { m_parallelMode = mode; }
+    ParallelMode parallelMode() const { return m_parallelMode; }
+
+    // 半步搜索: 把皇后移动与射箭作为两层分别搜索, 两者之间同样可以评估与剪枝,
+    // 看到糟糕的落点后整组射箭点都不必展开; 此时深度以半步计, 一步完整走法占两层
+    // 根节点仍枚举完整走法; YBW 只在根节点分裂
+    // 两种模式的深度含义不同, 切换时清空置换表
+    void setHalfPlySearch(bool enabled);
+    bool halfPlySearch() const { return m_halfPly; }
+
+    // 选择性搜索的参数, 辅助线程使用主线程的设置
+    void setOptions(const SearchOptions &options) { m_options = options; }
+    const SearchOptions &options() const { return m_options; }
+
+    // 为根局面选择下一步: 官子阶段按回溯求得的走法序列行棋, 否则迭代加深搜索
+    // 时间用完时中止当前迭代, 返回最后一次完成的迭代所得的走法
+    // 无棋可走时返回空走法
+    PackedMove nextMove(const SearchLimits &limits);
+    // 固定 depth 层搜索(半步搜索中为 depth 个半步, 至少为2)
+    PackedMove nextMove(int depth);
+    // 最近一次搜索的深度、评分、节点数与耗时
+    const SearchInfo &lastSearchInfo() const { return m_info; }
+    // 最近一次搜索得到的主要变例, 即双方预期的最佳走法序列
+    const QVector<PackedMove> &principalVariation() const { return m_pv; }
+
+    // 获取沙盒局面下指定阵营的所有可能走法
+    AllMoves getAllMovesForSide(bool isWhite) const;
+    AllMoves getAllMovesForSide(const Position &position, bool isWhite, const RegionTracker &regions) const;
+    // 判断指定一方是否进入官子阶段(所有棋子均被封闭或无法移动)
+    static bool isEndgame(const Position &position, const RegionTracker &regions, bool isWhite);
+    // 根局面是否已进入官子阶段, 此后 nextMove 按回溯求得的走法序列行棋
+    bool inEndgame() const { return m_endgame || isEndgame(m_sandbox, m_regions, m_isWhite); }
+    // 以本方视角评估任意局面, 会覆盖沙盒局面(下次搜索前由 setRootPosition 恢复)
+    double evaluate(const Position &position);
+
+    // 参与走法生成的棋子: 非官子阶段跳过处于封闭区域的棋子
+    Bitboard getSearchablePieces(const Position &position, bool isWhite, const RegionTracker &regions) const;
+    // 直接生成所有合法走法列表
+    void generateLegalMoves(bool forWhite, MoveList<N> &moves) const;
+    void generateLegalMoves(const Position &position, bool forWhite, const RegionTracker &regions, MoveList<N> &moves) const;
+
+private:
+    friend struct AllocCheck; // 内存分配检查工具(alloccheck.cpp)直接调用 getBestMove
+
+    // 评估函数的标准化常数, 8x8 下依次为 27, 54, 3.5, 28, 56
+    static constexpr double MaxQueenMoves = maxQueenMoves<N>();   // 单个皇后最大走法数
+    static constexpr double TerritoryScale = Geometry::Squares - 10; // 领地面积
+    static constexpr double CenterCoord = (N - 1) / 2.0;          // 中心坐标
+    static constexpr double CenterScale = 4.0 * (N - 1);          // 四子到中心的曼哈顿距离
+    static constexpr double DispersionScale = 8.0 * (N - 1);      // 六对棋子间的曼哈顿距离
+
+    // 期望窗口的初始半宽与上限, 超过上限后该侧直接使用完整窗口
+    static constexpr double AspirationWindow = 0.1;
+    static constexpr double MaxAspirationWindow = 1.0;
+
+    Position m_root;    // 根局面, 即真实棋盘状态
+    Position m_sandbox; // 沙盒局面，用于模拟走法, 通过 make/unmake 增量修改
+    RegionTracker m_regions; // 沙盒局面的区域划分, 随行棋增量更新
+
+    bool m_isWhite; // 是否为白方AI
+
+    std::unique_ptr<SearchStack<N>> m_stack; // 搜索栈, 构造时分配一次
+    std::unique_ptr<HistoryTable<N>> m_history; // 历史启发表, 跨越多次搜索逐渐衰减
+    std::unique_ptr<CounterMoveTable<N>> m_counterMoves; // 反制走法表
+    std::shared_ptr<TranspositionTable<N>> m_tt; // 置换表, 跨越多次搜索保留, 与辅助线程共享
+    typename TranspositionTable<N>::Stats m_hashStats; // 本线程的置换表统计
+
+    // 搜索控制
+    QElapsedTimer m_timer; // 本次搜索的计时
+    qint64 m_timeBudget = 0; // 本次搜索的时间预算(毫秒), 0 表示不限时间
+    const std::atomic<bool> *m_cancel = nullptr; // 本次搜索的取消令牌
+    const std::atomic<bool> *m_ponder = nullptr; // 本次搜索的后台思考标志
+    std::atomic<bool> m_stopFlag{false}; // 时间已用完或主线程已结束, 所有线程中止搜索
+    bool stopped() const { return m_main->m_stopFlag.load(std::memory_order_relaxed); }
+    // 全局中止, 或本线程所在的分裂点已被剪枝
+    bool aborted() const { return stopped() || (m_activeSplit && m_activeSplit->cancelled()); }
+    // 是否仍在后台思考, 此时时间预算不生效
+    bool pondering() const { return m_ponder && m_ponder->load(std::memory_order_relaxed); }
+    // 时间已用完或搜索已被取消
+    bool limitReached() const {
+        return (m_timeBudget > 0 && !pondering() && m_timer.elapsed() >= m_timeBudget)
+               || (m_cancel && m_cancel->load(std::memory_order_relaxed));
+    }
+    quint64 m_nodes = 0; // 本次搜索的节点数
+    SearchInfo m_info; // 最近一次搜索的信息
+    QVector<PackedMove> m_pv; // 最近一次完成的迭代的主要变例
+
+    // 多线程搜索
+    Search *m_main; // 主线程的搜索对象(主线程中为自身), 持有中止标志与全部辅助线程
+    std::vector<std::unique_ptr<Search>> m_helpers; // 辅助线程的搜索对象, 各自持有沙盒、搜索栈与排序表
+    ParallelMode m_parallelMode = ParallelMode::LazySmp;
+    bool m_halfPly = false; // 是否为半步搜索, 辅助线程读取主线程的设置
+    SearchOptions m_options; // 选择性搜索的参数, 同上
+    // 构造辅助线程的搜索对象, 与主搜索共享置换表与中止标志
+    Search(Search &main, int);
+    void resetThreadState(); // 每次搜索开始时清空本线程的统计与杀手走法, 衰减历史表
+    void helperSearch(int index, int maxDepth); // Lazy SMP 辅助线程的迭代加深, 直到主线程要求中止
+
+    // Young Brothers Wait: 每个线程按层序持有自己创建的分裂点, 作为工作窃取的双端队列:
+    // 创建者在底部压入与弹出, 空闲线程从顶部(最浅、剩余工作最多的)开始查找可加入的分裂点
+    static constexpr int MinSplitDepth = 2; // 剩余深度不足时子树太小, 不值得复制局面交给其他线程
+    std::unique_ptr<SplitPoint<N>[]> m_splitPoints; // 容量为 MaxPly, 仅在有辅助线程时分配
+    int m_splitCount = 0;
+    std::mutex m_splitMutex; // 保护 m_splitCount 与线程加入分裂点
+    SplitPoint<N> *m_activeSplit = nullptr; // 本线程正在参与的最内层分裂点
+    std::atomic<int> m_idleHelpers{0}; // (主线程中)正在等待分裂点的辅助线程数
+
+    bool canSplit(int depth) const;
+    // 在当前沙盒局面创建分裂点, 窗口与已有最佳结果取自串行搜索过的第一个子节点
+    SplitPoint<N> &openSplit(int ply, int depth, bool maximizingPlayer, double alpha, double beta,
+                             double bestEval, PackedMove bestMove, int moveIndex);
+    void runSplit(SplitPoint<N> &split); // 与加入的线程一起搜索完分裂点的走法, 然后关闭它
+    void searchSplit(SplitPoint<N> &split); // 逐个领取分裂点的走法搜索, 直到领完或被剪枝
+    SplitPoint<N> *stealSplit(); // 在其他线程中找到仍可加入的分裂点并登记加入
+    void helperWaitForWork(); // YBW 辅助线程的主循环, 直到主线程要求中止
+
+    // 官子阶段
+    bool m_endgame; // 是否处于官子阶段
+    QVector<PackedMove> m_endgameMoves; // 在官子阶段记录当前棋子的行棋策略
+    QSet<quint64> m_endgameVisited; // 记录官子阶段已访问的局面哈希值
+
+    QVector<PackedMove> getEndgameMoves(int pieceSquare = -1); // 获取官子阶段一个棋子的行棋策略
+
+    void makeMoveInSandbox(PackedMove move); // 在沙盒局面上执行一步走法, 并同步区域划分
+    void unmakeMoveInSandbox(PackedMove move); // 撤销沙盒局面上的一步走法
+    void resetSandbox(); // 重置沙盒局面为根局面
+
+    // 评估所需的一方机动性统计, 只计数不生成走法
+    struct Mobility
+    {
+        std::array<int, 4> squares{}; // 四个棋子所在格子
+        int moveOpts = 0;     // 移动方式总数 (排除被封闭的棋子)
+        int actionCount = 0;  // 行棋方式总数 (排除被封闭的棋子)
+        int territory = 0;    // 被封闭棋子的领地面积之和
+        bool endgame = true;  // 是否所有棋子均被封闭或无法移动
+    };
+    Mobility countMobility(bool isWhite) const; // 统计沙盒局面下一方的机动性
+
+    // 行棋算法
+    // Minimax算法
+    double evalSandbox(); // 计算当前沙盒局面评分
+    PackedMove iterativeDeepening(const SearchLimits &limits); // 迭代加深直到达到限制
+    // 在 (alpha, beta) 窗口内完成一次 depth 层的根节点搜索, 获取最佳走法及其评分
+    PackedMove getBestMove(int depth, double alpha, double beta, double &score);
+    void updatePv(int ply, PackedMove move); // 以 move 接上下一层的主要变例作为本层的主要变例
+    void checkTime(); // 定期检查是否已超出时间预算或被取消
+    // Alpha-Beta 搜索函数
+    // ply: 距根节点的层数
+    // alpha: 当前层最大化玩家已找到的最好值
+    // beta: 当前层最小化玩家已找到的最好值
+    double alphaBeta(int ply, int depth, double alpha, double beta, bool maximizingPlayer);
+    // 记录引起剪枝的走法, 供之后的走法排序使用
+    // previousMove 为到达本节点的上一步走法, 反制走法以它为索引
+    void recordCutoff(int ply, int depth, bool isWhite, PackedMove move, int moveIndex, PackedMove previousMove);
+
+    // 选择性搜索
+    int beamWidth(int depth) const; // 剩余深度为 depth 的节点的束宽, 0 表示不限
+    int lateMoveReduction(int depth, int moveIndex) const; // 本节点第 moveIndex 个走法的子节点少搜的层数
+    // 第一个之后的兄弟走法: 以零窗口试探(先少搜 reduction 层), 结果落入窗口时再完整搜索
+    // ply 与 depth 为子节点的层数与剩余深度, maximizingPlayer 为本节点的一方
+    double searchSibling(int ply, int depth, int reduction, double alpha, double beta, bool maximizingPlayer);
+
+    // 半步搜索
+    int moveDepth() const { return m_main->m_halfPly ? 2 : 1; } // 一步完整走法消耗的深度
+    // 完整走法之后的子节点: 按模式转入 alphaBeta 或皇后层
+    double searchReply(int ply, int depth, double alpha, double beta, bool maximizingPlayer);
+    // 皇后层: 逐个尝试行棋方的皇后移动, 然后转入射箭层; 主要变例由射箭层记录完整走法
+    double queenPly(int ply, int depth, double alpha, double beta, bool maximizingPlayer);
+    // 射箭层: 沙盒中的皇后已从 from 移到 to, 尚未射箭, 行棋方不变
+    double arrowPly(int ply, int depth, double alpha, double beta, bool maximizingPlayer, int from, int to);
+    // 按得分降序插入排序, 得分相同时保持生成顺序; 半步搜索每层的走法只有几十到一百多个
+    static void sortByScore(MoveList<N> &moves, std::array<int, MoveList<N>::Capacity> &scores);
+    // 按得分降序排序根节点走法, 得分相同时保持原顺序; 根节点的走法可达数千个, 不用插入排序
+    static void sortRootMoves(MoveList<N> &moves, std::array<int, MoveList<N>::Capacity> &scores);
+
+    // 评估函数权重
+    EvalWeights m_weights;
+};
+
+extern template class Search<8>;
+extern template class Search<10>;
+
+#endif // SEARCH_H
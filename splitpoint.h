@@ -0,0 +1,64 @@
+#ifndef SPLITPOINT_H
+#define SPLITPOINT_H
+
+#include <atomic>
+#include <mutex>
+#include "movepicker.h"
+#include "regiontracker.h"
+
+// 并行搜索(Young Brothers Wait)的分裂点
+// 一个节点的第一个子节点串行搜索完毕后, 其余兄弟走法在这里公开, 空闲线程复制节点局面后加入, 与创建者逐个领取走法搜索
+// 任一线程在此发生剪枝时置 cutoff, 所有参与线程(以及以它为祖先的分裂点上的线程)随即放弃手头的子树
+template <int N>
+struct SplitPoint
+{
+    using PackedMove = BasicPackedMove<N>;
+    static constexpr int MaxPly = SearchStack<N>::MaxPly;
+
+    // 创建时确定, 之后只读
+    SplitPoint *parent = nullptr; // 创建者当时正在参与的分裂点
+    BasicPosition<N> position; // 节点局面
+    BasicRegionTracker<N> regions; // 节点局面的区域划分
+    int ply = 0;
+    int depth = 0;
+    bool maximizing = false;
+    bool isWhite = false; // 节点的行棋方
+    PackedMove previousMove; // 到达节点的上一步走法, 用于更新反制走法表(辅助线程的搜索栈中没有这一层)
+
+    // 以下由 mutex 保护
+    std::mutex mutex;
+    MovePicker<N> *picker = nullptr; // 非根节点的走法来源, 公开前已生成全部走法
+    const MoveList<N> *moves = nullptr; // 根节点的走法来源
+    int nextIndex = 0; // moves 中下一个要领取的走法
+    int moveIndex = 0; // 下一个领取的走法在本节点中的序号
+    int moveLimit = 0; // 束宽: 序号达到此值后不再领取, 0 表示不限
+    double alpha = 0.0;
+    double beta = 0.0;
+    double bestEval = 0.0;
+    PackedMove bestMove;
+    std::array<PackedMove, MaxPly> pv; // 本节点的主要变例
+    int pvLength = 0;
+    bool finished = false; // 走法已领取完毕或已剪枝, 不再接受新的线程加入
+
+    std::atomic<bool> cutoff{false};
+    std::atomic<int> workers{0}; // 正在此处搜索的其他线程数
+
+    // 领取下一步走法, 调用者需持有 mutex
+    bool nextMove(PackedMove &move) {
+        if (moveLimit > 0 && moveIndex >= moveLimit) return false;
+        if (picker) return picker->next(move);
+        if (nextIndex >= moves->size()) return false;
+        move = (*moves)[nextIndex++];
+        return true;
+    }
+
+    // 本分裂点或其任一祖先已经剪枝, 正在搜索的子树结果不再需要
+    bool cancelled() const {
+        for (const SplitPoint *split = this; split; split = split->parent) {
+            if (split->cutoff.load(std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+};
+
+#endif // SPLITPOINT_H
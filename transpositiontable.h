@@ -0,0 +1,158 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include "position.h"
+
+// 置换表: 以局面哈希值为键, 记录已搜索局面的深度、评分、界类型与最佳走法
+// 亚马逊棋中同样两支箭以不同顺序射出即得到相同局面, 置换表使兄弟子树之间可以共享结果
+// 表项数为2的幂, 以哈希值低位直接定位
+//
+// 多个搜索线程共享同一张表且不加锁: 每个表项由三个原子字组成(校验字、评分、其余数据),
+// 校验字为 键 ^ 评分 ^ 数据. 两个线程同时写入同一表项造成的撕裂在读取时校验不通过, 按未命中处理
+template <int N>
+class TranspositionTable
+{
+public:
+    using PackedMove = BasicPackedMove<N>;
+
+    static constexpr int DefaultSizeMB = 16;
+
+    // 评分的界类型
+    enum Bound : quint8 {
+        NoBound = 0,
+        Exact = 1, // 精确值
+        Lower = 2, // 下界: 发生了 Beta 剪枝, 真实值不低于评分
+        Upper = 3  // 上界: 没有走法超过 Alpha, 真实值不高于评分
+    };
+
+    // 解码后的表项
+    struct Entry
+    {
+        quint64 key = 0;
+        double score = 0.0;
+        PackedMove move; // 最佳走法(或引起剪枝的走法)
+        qint16 depth = -1;
+        Bound bound = NoBound;
+        quint8 age = 0;  // 写入时的搜索代数
+    };
+
+    // 命中统计, 由各搜索线程分别累计
+    struct Stats
+    {
+        quint64 probes = 0; // 查询次数
+        quint64 hits = 0;   // 命中次数
+
+        double hitRate() const { return probes == 0 ? 0.0 : static_cast<double>(hits) / probes; }
+        Stats &operator+=(const Stats &other) {
+            probes += other.probes;
+            hits += other.hits;
+            return *this;
+        }
+    };
+
+    explicit TranspositionTable(int sizeMB = DefaultSizeMB) { resize(sizeMB); }
+
+    // 按不超过 sizeMB 的最大2的幂重新分配表项, 原有内容清空
+    // 不能与搜索同时调用
+    void resize(int sizeMB)
+    {
+        const quint64 bytes = static_cast<quint64>(qMax(sizeMB, 1)) * 1024 * 1024;
+        quint64 count = 1;
+        while (count * 2 * sizeof(Slot) <= bytes) count *= 2;
+        m_slots = std::make_unique<Slot[]>(count);
+        m_count = count;
+        m_mask = count - 1;
+        clear();
+    }
+
+    // 不能与搜索同时调用
+    void clear()
+    {
+        for (quint64 i = 0; i < m_count; i++) {
+            m_slots[i].check.store(0, std::memory_order_relaxed);
+            m_slots[i].score.store(0, std::memory_order_relaxed);
+            m_slots[i].data.store(0, std::memory_order_relaxed);
+        }
+        m_age = 0;
+    }
+
+    // 开始新一次搜索: 旧搜索留下的表项视为过期, 可被优先替换
+    void newSearch() { m_age = static_cast<quint8>(m_age + 1); }
+
+    // 查询局面, 命中时将表项写入 entry
+    bool probe(quint64 key, Entry &entry, Stats &stats) const
+    {
+        stats.probes++;
+        const Slot &slot = m_slots[key & m_mask];
+        const quint64 data = slot.data.load(std::memory_order_relaxed);
+        const quint64 score = slot.score.load(std::memory_order_relaxed);
+        const quint64 check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ score ^ data) != key) return false;
+
+        entry = decode(key, score, data);
+        if (entry.bound == NoBound) return false;
+        stats.hits++;
+        return true;
+    }
+
+    // 写入局面
+    // 替换策略: 同一局面总是更新; 其他局面的表项若是本次搜索写入且深度更深, 则保留不替换
+    void store(quint64 key, int depth, double score, Bound bound, PackedMove move)
+    {
+        Slot &slot = m_slots[key & m_mask];
+        const quint64 oldData = slot.data.load(std::memory_order_relaxed);
+        const quint64 oldScore = slot.score.load(std::memory_order_relaxed);
+        const quint64 oldCheck = slot.check.load(std::memory_order_relaxed);
+        const quint64 oldKey = oldCheck ^ oldScore ^ oldData;
+        const Entry old = decode(oldKey, oldScore, oldData);
+
+        if (old.bound != NoBound && oldKey != key && old.age == m_age && old.depth > depth) {
+            return;
+        }
+        // 没有最佳走法时(如全部走法都低于 Alpha)保留同一局面此前的走法用于排序
+        if (move.isNull() && oldKey == key) move = old.move;
+
+        quint64 scoreBits;
+        std::memcpy(&scoreBits, &score, sizeof(scoreBits));
+        const quint64 data = static_cast<quint64>(move.bits)
+                             | (static_cast<quint64>(static_cast<quint16>(depth)) << 32)
+                             | (static_cast<quint64>(bound) << 48)
+                             | (static_cast<quint64>(m_age) << 56);
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.score.store(scoreBits, std::memory_order_relaxed);
+        slot.check.store(key ^ scoreBits ^ data, std::memory_order_relaxed);
+    }
+
+    int sizeMB() const { return static_cast<int>(m_count * sizeof(Slot) / (1024 * 1024)); }
+    quint64 entryCount() const { return m_count; }
+
+private:
+    struct Slot
+    {
+        std::atomic<quint64> check{0}; // 键 ^ 评分 ^ 数据
+        std::atomic<quint64> score{0}; // 评分(double 的位模式)
+        std::atomic<quint64> data{0};  // 走法(低32位) | 深度(16位) | 界类型(8位) | 代数(8位)
+    };
+
+    static Entry decode(quint64 key, quint64 scoreBits, quint64 data)
+    {
+        Entry entry;
+        entry.key = key;
+        std::memcpy(&entry.score, &scoreBits, sizeof(scoreBits));
+        entry.move.bits = static_cast<quint32>(data);
+        entry.depth = static_cast<qint16>(static_cast<quint16>(data >> 32));
+        entry.bound = static_cast<Bound>((data >> 48) & 0xff);
+        entry.age = static_cast<quint8>(data >> 56);
+        return entry;
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    quint64 m_count = 0;
+    quint64 m_mask = 0;
+    quint8 m_age = 0;
+};
+
+#endif // TRANSPOSITIONTABLE_H
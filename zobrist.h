@@ -0,0 +1,48 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <QtGlobal>
+#include <array>
+
+// Zobrist 哈希键表: 每种棋子在每个格子上各对应一个随机数, 另有一个行棋方随机数
+// 按位棋盘支持的最大格子数生成, 各尺寸的棋盘共用
+// pendingArrow 用于半步搜索中皇后已移动、尚未射箭的局面, 以射箭的皇后所在格子区分
+struct ZobristKeys
+{
+    static constexpr int MaxSquares = 128;
+
+    std::array<quint64, MaxSquares> white{};
+    std::array<quint64, MaxSquares> black{};
+    std::array<quint64, MaxSquares> arrows{};
+    quint64 blackToMove = 0;
+    std::array<quint64, MaxSquares> pendingArrow{};
+};
+
+// SplitMix64 伪随机数生成, 用于在编译期生成固定的键表
+constexpr quint64 splitMix64(quint64 &state)
+{
+    quint64 z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys()
+{
+    ZobristKeys keys;
+    quint64 state = 0x416d617a6f6e73ULL;
+    for (int square = 0; square < ZobristKeys::MaxSquares; square++) {
+        keys.white[square] = splitMix64(state);
+        keys.black[square] = splitMix64(state);
+        keys.arrows[square] = splitMix64(state);
+    }
+    keys.blackToMove = splitMix64(state);
+    for (int square = 0; square < ZobristKeys::MaxSquares; square++) {
+        keys.pendingArrow[square] = splitMix64(state);
+    }
+    return keys;
+}
+
+inline constexpr ZobristKeys Zobrist = makeZobristKeys();
+
+#endif // ZOBRIST_H